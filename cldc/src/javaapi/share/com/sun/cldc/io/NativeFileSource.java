@@ -0,0 +1,50 @@
+/*
+ *   
+ *
+ * Copyright  1990-2007 Sun Microsystems, Inc. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License version
+ * 2 only, as published by the Free Software Foundation.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License version 2 for more details (a copy is
+ * included at /legal/license.txt).
+ * 
+ * You should have received a copy of the GNU General Public License
+ * version 2 along with this work; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ * 
+ * Please contact Sun Microsystems, Inc., 4150 Network Circle, Santa
+ * Clara, CA 95054 or visit www.sun.com if you need additional
+ * information or have any questions.
+ */
+
+package com.sun.cldc.io;
+
+import java.io.*;
+
+/**
+ * Implemented by input streams that read a file the native layer can
+ * access directly. Connections that can send file data without copying it
+ * through the Java heap, such as <code>socket</code>, use the handle to
+ * read the file themselves.
+ */
+public interface NativeFileSource {
+
+    /**
+     * Returns the native handle the stream reads the file through. Data
+     * consumed through the handle advances the stream, so reading can
+     * continue with the stream afterwards.
+     *
+     * @return the native file handle, or <code>0</code> if the stream
+     *         cannot hand out its file right now, for example because it
+     *         buffers data for <code>reset</code>
+     * @exception IOException if the stream is closed
+     */
+    public int getNativeReadHandle() throws IOException;
+}
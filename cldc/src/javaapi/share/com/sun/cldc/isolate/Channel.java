@@ -0,0 +1,142 @@
+/*
+ *   
+ *
+ * Copyright  1990-2007 Sun Microsystems, Inc. All Rights Reserved.
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER
+ * 
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License version
+ * 2 only, as published by the Free Software Foundation.
+ * 
+ * This program is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+ * General Public License version 2 for more details (a copy is
+ * included at /legal/license.txt).
+ * 
+ * You should have received a copy of the GNU General Public License
+ * version 2 along with this work; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA
+ * 02110-1301 USA
+ * 
+ * Please contact Sun Microsystems, Inc., 4150 Network Circle, Santa
+ * Clara, CA 95054 or visit www.sun.com if you need additional
+ * information or have any questions.
+ */
+
+package com.sun.cldc.isolate;
+
+/**
+ * A <code>Channel</code> passes byte array messages between isolates
+ * without going through sockets or files. A channel is identified by
+ * an integer id. One isolate creates the channel with {@link #create()}
+ * and passes the id to other isolates, for example as a startup
+ * argument. They attach to it with {@link #Channel(int)}. <p>
+ *
+ * A channel belongs to the isolate that created it. Other isolates can
+ * use it only after the owner called {@link #allow(Isolate)} for them,
+ * otherwise the operations throw <code>SecurityException</code>. The
+ * channel is destroyed when the owner closes it or terminates. <p>
+ *
+ * Messages are delivered in the order they were sent. Each message is
+ * received by exactly one receiver. The data is copied out of the sender's
+ * array when the message is sent. The received array is allocated in the
+ * receiving isolate and counts against its memory quota. <p>
+ *
+ * Messages in transit are kept outside of the object heap. The size of
+ * the messages queued in one channel, and so the size of a message, is
+ * limited by the <code>IsolateChannelBufferSize</code> VM flag.
+ */
+public final class Channel {
+    private final int id;
+
+    /**
+     * Creates a new channel with an id that is unique in the VM.
+     *
+     * @return the new channel
+     */
+    public static Channel create() {
+        return new Channel(createId0());
+    }
+
+    /**
+     * Allows another isolate to use this channel. Only the isolate that
+     * created the channel can do this. Call it right after starting the
+     * isolate, before the isolate uses the channel.
+     *
+     * @param isolate a started isolate
+     * @exception SecurityException if the current isolate does not own
+     *            this channel
+     * @exception IllegalArgumentException if <code>isolate</code> is not
+     *            running
+     */
+    public void allow(Isolate isolate) {
+        allow0(id, isolate.id());
+    }
+
+    /**
+     * Attaches to the channel with the given id.
+     *
+     * @param id the id of a channel created with {@link #create()}
+     */
+    public Channel(int id) {
+        this.id = id;
+    }
+
+    /**
+     * @return the id of this channel, to be passed to other isolates
+     */
+    public int id() {
+        return id;
+    }
+
+    /**
+     * Queues a copy of <code>length</code> bytes of <code>data</code>,
+     * starting at <code>offset</code>, as one message. The call does not
+     * block.
+     *
+     * @return true if the message has been queued, false if the channel
+     *         buffers are full
+     * @exception NullPointerException if <code>data</code> is null
+     * @exception IndexOutOfBoundsException if <code>offset</code> and
+     *            <code>length</code> are outside of <code>data</code>
+     * @exception IllegalArgumentException if <code>length</code> is
+     *            larger than the channel buffer
+     * @exception SecurityException if the channel does not exist or the
+     *            current isolate may not use it
+     */
+    public boolean send(byte[] data, int offset, int length) {
+        if (offset < 0 || length < 0 || offset > data.length - length) {
+            throw new IndexOutOfBoundsException();
+        }
+        return send0(id, data, offset, length);
+    }
+
+    /**
+     * Removes the oldest message from this channel. Blocks the calling
+     * thread until a message is available.
+     *
+     * @return the message data
+     * @exception SecurityException if the channel does not exist, is
+     *            closed while waiting, or the current isolate may not
+     *            use it
+     */
+    public byte[] receive() {
+        return receive0(id);
+    }
+
+    /**
+     * Called by the owner, destroys this channel and discards the queued
+     * messages. Called by another isolate, gives up its access to the
+     * channel.
+     */
+    public void close() {
+        close0(id);
+    }
+
+    private native static int createId0();
+    private native static void allow0(int id, int taskId);
+    private native boolean send0(int id, byte[] data, int offset, int length);
+    private native byte[] receive0(int id);
+    private native void close0(int id);
+}
@@ -695,6 +695,20 @@ public final class Isolate {
     }
     private native int usedMemory0();
 
+    /**
+     * This function returns the approximate amount of CPU time used
+     * by this Isolate so far. The time is measured when the VM switches
+     * between threads of different Isolates, so it may not include
+     * the time slice that is currently running. <p>
+     *
+     * @return the CPU time in milliseconds used by this Isolate, or 0 if
+     * the Isolate has not been started or it has been terminated.
+     */
+    public long cpuTime() {
+        return cpuTime0();
+    }
+    private native long cpuTime0();
+
     /**
      * Sets the object heap memory reserved and maximum limits to the
      * same value. Note that if the system does not have sufficient
@@ -34,6 +34,15 @@ public class JVM {
      */
     public static final int REMOVE_CLASSES_FROM_JAR = (1 << 1);
 
+    /**
+     * If this flag is defined, the static initializers of the application
+     * classes are executed during the conversion, and the classes are
+     * saved in the image in the initialized state, so that the
+     * initializers do not run again when the application starts. This
+     * parameter is ignored for source romization.
+     */
+    public static final int INITIALIZE_CLASSES = (1 << 3);
+
     /**
      * Returned by getAppImageProgress() to indicate that the last image
      * creation process has was cancelled before it was completed.
@@ -179,6 +188,23 @@ public class JVM {
     public native static void loadLibrary(String libName)
          throws Error;
 
+    /**
+     * Forks the worker processes requested with -XX:PreforkWorkers.
+     * Call this once the application has warmed up, for example after
+     * its classes are initialized and its server socket is open. The
+     * workers share the state of the VM at this point copy-on-write and
+     * each continue by returning from this method. The calling process
+     * restarts workers killed by a signal, up to -XX:PreforkRestartLimit
+     * times per -XX:PreforkRestartPeriod, and exits when the workers
+     * finished, it does not return from this method. A worker exiting
+     * with a non-zero status stops the restarts and the calling process
+     * exits with that status.
+     * <p>
+     * If PreforkWorkers is not set, if the platform does not support
+     * it, or when called in a worker, this method returns immediately.
+     */
+    public native static void forkWorkers();
+
 
     /**
      * Copy an array from the specified source array, beginning at the
@@ -88,6 +88,7 @@ extern "C" {
 #include <javacall_directui.h>
 #endif
 #include <javacall_network.h>
+#include <javacall_os.h>
 #ifdef ENABLE_JSR_120
 #include <javacall_sms.h>
 #endif
@@ -456,6 +457,16 @@ extern "C" void javanotify_key_event(javacall_keypress_code key,
 #endif
 
 
+extern "C" void javanotify_os_offload_done(void* arg) {
+    SNIReentryData rd;
+
+    rd.status = 0;
+    rd.descriptor = (int)arg;
+    rd.pContext = (void*)0;
+    rd.waitingFor = OFFLOAD_SIGNAL;
+    javacall_event_send((unsigned char*)&rd, sizeof(SNIReentryData));
+}
+
 #if ENABLE_SECURITY_NATIVE_RSA_SIGNATURE
 #include "javacall_security.h"
 
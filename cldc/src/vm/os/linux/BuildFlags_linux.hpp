@@ -60,3 +60,10 @@
 #ifndef SUPPORTS_MEMORY_MAPPED_FILES
 #define SUPPORTS_MEMORY_MAPPED_FILES 1
 #endif
+
+// Linux port can fork worker processes off a booted VM (see
+// Os::prefork_workers()). Override with -DSUPPORTS_PREFORK=0 in your
+// gcc command-line.
+#ifndef SUPPORTS_PREFORK
+#define SUPPORTS_PREFORK 1
+#endif
@@ -32,7 +32,16 @@
   product(int, TickInterval, 10,                                              \
           "Set the delay interval for servicing compiler generation")         \
   product(int, ExecutionLoops, 1,                                             \
-          "the number of times we run the VM (for measuring start-up time)")
+          "the number of times we run the VM (for measuring start-up time)")  \
+  product(int, PreforkWorkers, 0,                                             \
+          "If positive, JVM.forkWorkers() forks this many worker "            \
+          "processes. The workers share the warmed up heap copy-on-write; "   \
+          "the parent only restarts workers killed by a signal")              \
+  product(int, PreforkRestartLimit, 5,                                        \
+          "The number of prefork workers restarted within "                   \
+          "PreforkRestartPeriod before the parent gives up and exits")        \
+  product(int, PreforkRestartPeriod, 60000,                                   \
+          "The period (in ms) PreforkRestartLimit applies to")
 
 #define PLATFORM_RUNTIME_FLAGS(develop, product)         \
         PLATFORM_RUNTIME_FLAGS_GENERIC(develop, product)
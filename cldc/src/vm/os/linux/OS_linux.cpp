@@ -66,6 +66,10 @@
 #include <dlfcn.h>
 #endif
 
+#if SUPPORTS_PREFORK
+#include <sys/wait.h>
+#endif
+
 // IMPL_NOTE: the offset of PC value in ucontext_t structure
 // is different for every particular platform and OS.
 // Please change the value as suitable for your OS.
@@ -318,6 +322,98 @@ void Os::stop_ticks() {
 
 #endif // ENABLE_TIMER_THREAD
 
+#if SUPPORTS_PREFORK
+bool Os::prefork_workers(int* exit_code) {
+  if (PreforkWorkers <= 0) {
+    return false;
+  }
+
+  // Neither the ticker thread nor the interval timer survive fork(),
+  // so stop them here and restart them in each worker.
+  stop_ticks();
+  jvm_fflush(stdout);
+
+  int workers = 0;
+  bool forked = false;
+  bool restart = true;
+  int restarts = 0;
+  jlong restart_period_start = java_time_millis();
+  *exit_code = 0;
+  for (;;) {
+    while (restart && workers < PreforkWorkers) {
+      const pid_t pid = ::fork();
+      if (pid == 0) {
+        // Workers must not fork workers of their own
+        PreforkWorkers = 0;
+        start_ticks();
+        return false;
+      }
+      if (pid < 0) {
+        if (!forked) {
+          // Could not fork at all, run the application in this process
+          start_ticks();
+          return false;
+        }
+        restart = false;
+        break;
+      }
+      if (Verbose) {
+        TTY_TRACE_CR(("prefork: started worker %d", (int)pid));
+      }
+      forked = true;
+      workers++;
+    }
+    if (workers == 0) {
+      break;
+    }
+
+    int status;
+    const pid_t pid = ::waitpid(-1, &status, 0);
+    if (pid < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      break;
+    }
+    workers--;
+    if (WIFEXITED(status)) {
+      // The application finished or gave up in this worker, let the
+      // others finish too but don't start new ones.
+      restart = false;
+      if (*exit_code == 0) {
+        *exit_code = WEXITSTATUS(status);
+      }
+      continue;
+    }
+
+    // Killed by a signal, restart it unless it keeps failing
+    const int code = 128 + WTERMSIG(status);
+    if (restart) {
+      const jlong now = java_time_millis();
+      if (now - restart_period_start >= PreforkRestartPeriod) {
+        restart_period_start = now;
+        restarts = 0;
+      }
+      if (++restarts <= PreforkRestartLimit) {
+        if (Verbose) {
+          TTY_TRACE_CR(("prefork: worker %d killed by signal %d, restarting",
+                        (int)pid, WTERMSIG(status)));
+        }
+        continue;
+      }
+      if (Verbose) {
+        TTY_TRACE_CR(("prefork: workers keep failing, giving up"));
+      }
+      restart = false;
+    }
+    if (*exit_code == 0) {
+      *exit_code = code;
+    }
+  }
+  return true;
+}
+#endif // SUPPORTS_PREFORK
+
 #if !ENABLE_TIMER_THREAD
 extern "C" void handle_vtalrm_signal(int signo, siginfo_t* sigi, void* uc) {
   GUARANTEE(!is_processing_timer_tick, "Sanity");
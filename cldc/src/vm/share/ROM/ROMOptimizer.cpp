@@ -808,7 +808,11 @@ bool ROMOptimizer::may_be_initialized(InstanceClass *klass) {
       return false;
     }
 #else
-    return false;
+    // Application classes are initialized ahead of time only on request,
+    // their initializers may depend on the run-time environment.
+    if ((ROMWriter::flags() & JVM_INITIALIZE_CLASSES) == 0) {
+      return false;
+    }
 #endif
   }
 
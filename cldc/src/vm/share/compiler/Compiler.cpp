@@ -217,6 +217,32 @@ void Compiler::on_timer_tick(bool is_real_time_tick JVM_TRAPS) {
   }
 }
 
+// Called by the scheduler when no Java thread is runnable. A suspended
+// compilation is continued for one time slice, so that less of it is
+// left to be done in the time slices of Java threads. Returns true if
+// the compilation is still suspended afterwards and can use more idle time.
+bool Compiler::resume_when_idle(const jlong idle_time) {
+  if( !CompileWhenIdle || !UseCompiler || !is_suspended() ||
+      !Universe::is_compilation_allowed() ) {
+    return false;
+  }
+  if( idle_time >= 0 && idle_time < (jlong)MaxCompilationTime ) {
+    return false;
+  }
+
+  UsingFastOops fast_oops;
+  CompiledMethod::Raw suspended_compiled_method =
+    _compiler_state->compiled_method();
+  if( suspended_compiled_method.is_null() ) {
+    return false;
+  }
+  Method::Fast current_compiling = suspended_compiled_method().method();
+
+  SETUP_ERROR_CHECKER_ARG;
+  current_compiling().compile(0, true JVM_MUST_SUCCEED);
+  return is_suspended();
+}
+
 #if ENABLE_INTERPRETATION_LOG
 void Compiler::process_interpretation_log() {
   jlong now = Os::java_time_millis();
@@ -519,6 +519,7 @@ class Compiler: public BytecodeCompileClosure {
 
  public:
   static void on_timer_tick(bool is_real_time_tick JVM_TRAPS);
+  static bool resume_when_idle(const jlong idle_time);
   static void process_interpretation_log();
 
   static void set_hint(const int hint) {
@@ -847,5 +848,8 @@ public:
   }
   static void abort_suspended_compilation() {}
   static void on_timer_tick() {}
+  static bool resume_when_idle(const jlong /*idle_time*/) {
+    return false;
+  }
 };
 #endif
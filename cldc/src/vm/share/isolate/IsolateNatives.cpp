@@ -59,6 +59,13 @@ int Java_com_sun_cldc_isolate_Isolate_usedMemory0() {
     ObjectHeap::get_task_memory_estimate( task );
 }
 
+// private native long cpuTime0();
+jlong Java_com_sun_cldc_isolate_Isolate_cpuTime0() {
+  IsolateObj::Raw isolate = GET_PARAMETER_AS_OOP(0);
+  const jint task = isolate().task_id();
+  return task == Task::INVALID_TASK_ID ? 0 : Scheduler::task_cpu_time(task);
+}
+
 /*
  * void nativeStart(Object [] startupState)
  * where startupState contains the following:
@@ -73,6 +80,7 @@ void Java_com_sun_cldc_isolate_Isolate_nativeStart(JVM_SINGLE_ARG_TRAPS) {
   Thread::Raw saved;
   bool has_exception = false;
   const int id = Task::allocate_task_id(JVM_SINGLE_ARG_CHECK);
+  Scheduler::reset_task_cpu_time(id);
   {
     UsingFastOops fast_oops;
     IsolateObj::Fast isolate = GET_PARAMETER_AS_OOP(0);
@@ -304,6 +312,187 @@ jint Java_com_sun_cldc_isolate_Link_nativeCreateLinkId() {
   return ++_linkIdGenerator;
 }
 
+/*----------------------------------------------------------------
+ * Channel support
+ *----------------------------------------------------------------*/
+
+/* Messages in transit are kept outside of the object heap, so they
+ * belong to neither isolate. The receiver allocates the byte array in
+ * its own task, so the data is copied once on each side and charged to
+ * the receiver only after it has been received.
+ */
+struct ChannelMessage {
+  ChannelMessage* _next;
+  jint            _length;
+  jbyte           _data[1];
+};
+
+/* A channel belongs to the task that created it and is destroyed when
+ * that task terminates. Other tasks can only use it after the owner has
+ * allowed them to. Each channel queues at most IsolateChannelBufferSize
+ * bytes, so a task that does not receive only blocks its own channels.
+ */
+struct IsolateChannel {
+  IsolateChannel* _next;
+  jint            _id;
+  jint            _owner;
+  // Bit mask of the tasks that may use the channel, MAX_TASKS <= 32
+  juint           _tasks;
+  jint            _bytes_queued;
+  ChannelMessage* _head;
+  ChannelMessage* _tail;
+};
+
+static IsolateChannel* _channels = NULL;
+static jint _channelIdGenerator = 0;
+
+static IsolateChannel* find_channel(const jint id, IsolateChannel** prev) {
+  *prev = NULL;
+  for (IsolateChannel* ch = _channels; ch != NULL; ch = ch->_next) {
+    if (ch->_id == id) {
+      return ch;
+    }
+    *prev = ch;
+  }
+  return NULL;
+}
+
+// Returns the channel if the current task may use it, otherwise
+// throws SecurityException.
+static IsolateChannel* get_accessible_channel(const jint id JVM_TRAPS) {
+  IsolateChannel* prev;
+  IsolateChannel* ch = find_channel(id, &prev);
+  if (ch == NULL ||
+      (ch->_tasks & (1u << TaskContext::current_task_id())) == 0) {
+    Throw::throw_exception(Symbols::java_lang_SecurityException()
+                           JVM_THROW_0);
+  }
+  return ch;
+}
+
+static void destroy_channel(IsolateChannel* ch, IsolateChannel* prev) {
+  if (prev == NULL) {
+    _channels = ch->_next;
+  } else {
+    prev->_next = ch->_next;
+  }
+  ChannelMessage* msg = ch->_head;
+  while (msg != NULL) {
+    ChannelMessage* next = msg->_next;
+    OsMemory_free(msg);
+    msg = next;
+  }
+  // Waiting receivers find the channel gone and throw
+  SNIEVT_signal(ISOLATE_CHANNEL_SIGNAL, ch->_id, 0);
+  OsMemory_free(ch);
+}
+
+// private native static int createId0();
+jint Java_com_sun_cldc_isolate_Channel_createId0(JVM_SINGLE_ARG_TRAPS) {
+  IsolateChannel* ch = (IsolateChannel*)
+    OsMemory_allocate(sizeof(IsolateChannel));
+  if (ch == NULL) {
+    Throw::out_of_memory_error(JVM_SINGLE_ARG_THROW_0);
+  }
+  ch->_id = ++_channelIdGenerator;
+  ch->_owner = TaskContext::current_task_id();
+  ch->_tasks = 1u << ch->_owner;
+  ch->_bytes_queued = 0;
+  ch->_head = NULL;
+  ch->_tail = NULL;
+  ch->_next = _channels;
+  _channels = ch;
+  return ch->_id;
+}
+
+// private native static void allow0(int id, int taskId);
+void Java_com_sun_cldc_isolate_Channel_allow0(JVM_SINGLE_ARG_TRAPS) {
+  const jint id = KNI_GetParameterAsInt(1);
+  const jint task_id = KNI_GetParameterAsInt(2);
+  IsolateChannel* ch = get_accessible_channel(id JVM_CHECK);
+  if (ch->_owner != TaskContext::current_task_id()) {
+    Throw::throw_exception(Symbols::java_lang_SecurityException() JVM_THROW);
+  }
+  if (task_id < 0 || task_id >= MAX_TASKS) {
+    Throw::throw_exception(Symbols::java_lang_IllegalArgumentException()
+                           JVM_THROW);
+  }
+  ch->_tasks |= 1u << task_id;
+}
+
+// private native boolean send0(int id, byte[] data, int offset, int length);
+jboolean Java_com_sun_cldc_isolate_Channel_send0(JVM_SINGLE_ARG_TRAPS) {
+  const jint id = KNI_GetParameterAsInt(1);
+  const jint offset = KNI_GetParameterAsInt(3);
+  const jint length = KNI_GetParameterAsInt(4);
+  IsolateChannel* ch = get_accessible_channel(id JVM_CHECK_0);
+  // offset and length are checked at Java level
+  if (length > IsolateChannelBufferSize) {
+    Throw::throw_exception(Symbols::java_lang_IllegalArgumentException()
+                           JVM_THROW_0);
+  }
+  if (ch->_bytes_queued > IsolateChannelBufferSize - length) {
+    return false;
+  }
+  ChannelMessage* msg = (ChannelMessage*)
+    OsMemory_allocate(sizeof(ChannelMessage) + length);
+  if (msg == NULL) {
+    return false;
+  }
+  TypeArray::Raw data = GET_PARAMETER_AS_OOP(2);
+  jvm_memcpy(msg->_data, data().byte_base_address() + offset, length);
+  msg->_next = NULL;
+  msg->_length = length;
+  if (ch->_tail == NULL) {
+    ch->_head = msg;
+  } else {
+    ch->_tail->_next = msg;
+  }
+  ch->_tail = msg;
+  ch->_bytes_queued += length;
+
+  SNIEVT_signal(ISOLATE_CHANNEL_SIGNAL, id, 0);
+  return true;
+}
+
+// private native byte[] receive0(int id);
+ReturnOop Java_com_sun_cldc_isolate_Channel_receive0(JVM_SINGLE_ARG_TRAPS) {
+  const jint id = KNI_GetParameterAsInt(1);
+  IsolateChannel* ch = get_accessible_channel(id JVM_CHECK_0);
+  ChannelMessage* msg = ch->_head;
+  if (msg == NULL) {
+    // This native is invoked again after a message has been sent
+    SNIEVT_wait(ISOLATE_CHANNEL_SIGNAL, id, NULL);
+    return NULL;
+  }
+  TypeArray::Raw result = Universe::new_byte_array_raw(msg->_length
+                                                       JVM_CHECK_0);
+  jvm_memcpy(result().byte_base_address(), msg->_data, msg->_length);
+  ch->_head = msg->_next;
+  if (ch->_head == NULL) {
+    ch->_tail = NULL;
+  }
+  ch->_bytes_queued -= msg->_length;
+  OsMemory_free(msg);
+  return result;
+}
+
+// private native void close0(int id);
+void Java_com_sun_cldc_isolate_Channel_close0() {
+  const jint id = KNI_GetParameterAsInt(1);
+  const int task_id = TaskContext::current_task_id();
+  IsolateChannel* prev;
+  IsolateChannel* ch = find_channel(id, &prev);
+  if (ch == NULL) {
+    return;
+  }
+  if (ch->_owner == task_id) {
+    destroy_channel(ch, prev);
+  } else {
+    ch->_tasks &= ~(1u << task_id);
+  }
+}
+
 void Java_com_sun_cldc_isolate_Isolate_setProfile(JVM_SINGLE_ARG_TRAPS) {
 #if ENABLE_MULTIPLE_PROFILES_SUPPORT
   UsingFastOops fast_oops;  
@@ -354,4 +543,20 @@ Java_com_sun_cldc_isolate_Isolate_isDebuggerConnected(JVM_SINGLE_ARG_TRAPS) {
 
 } // extern "C"
 
+void IsolateNatives::on_task_termination(const int task_id) {
+  const juint task_bit = 1u << task_id;
+  IsolateChannel* prev = NULL;
+  IsolateChannel* ch = _channels;
+  while (ch != NULL) {
+    IsolateChannel* next = ch->_next;
+    if (ch->_owner == task_id) {
+      destroy_channel(ch, prev);
+    } else {
+      ch->_tasks &= ~task_bit;
+      prev = ch;
+    }
+    ch = next;
+  }
+}
+
 
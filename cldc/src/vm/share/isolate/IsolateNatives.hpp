@@ -25,4 +25,8 @@
  */
 
 class IsolateNatives : public AllStatic {
+public:
+  // Destroys the channels created by a terminated task and revokes its
+  // access to the others.
+  static void on_task_termination(const int task_id);
 };
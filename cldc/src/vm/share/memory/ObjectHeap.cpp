@@ -49,6 +49,23 @@ address   ObjectHeap::_bitvector_start;
 bool      ObjectHeap::_is_gc_active;
 bool      ObjectHeap::_last_heap_expansion_failed;
 
+int       ObjectHeap::_tenuring_threshold;
+int       ObjectHeap::_young_generation_age;
+size_t    ObjectHeap::_promoted_since_full_collect;
+jlong     ObjectHeap::_last_collect_end_time;
+int       ObjectHeap::_gc_time_percentage;
+bool      ObjectHeap::_is_explicit_collect;
+
+// Time stamp used to measure the GC cost. Only ratios of these are used,
+// so the unit does not matter.
+static inline jlong gc_cost_time_stamp() {
+#if USE_HIGH_RESOLUTION_TIMER
+  return Os::elapsed_counter();
+#else
+  return Os::java_time_millis();
+#endif
+}
+
 OopDesc** ObjectHeap::_permanent_generation_top;
 
 #ifdef AZZERT
@@ -101,11 +118,11 @@ OopDesc** ObjectHeap::_saved_compiler_area_top_quick;
     } \
     \
     while (bitword) { \
-      if ((bitword & 0xFFFF) == 0) { bitword >>= 16; p += 16; } \
-      if ((bitword &   0xFF) == 0) { bitword >>=  8; p +=  8; } \
-      if ((bitword &    0xF) == 0) { bitword >>=  4; p +=  4; } \
-      if ((bitword &    0x3) == 0) { bitword >>=  2; p +=  2; } \
-      if ((bitword &    0x1) == 0) { bitword >>=  1; p +=  1; } \
+      { \
+        const int skip = lowest_set_bit(bitword); \
+        bitword >>= skip; \
+        p += skip; \
+      } \
       GUARANTEE(p >= start && p < end && test_bit_for(p), "Sanity"); \
       if (TraceGC) { \
         TTY_TRACE_CR(("TraceGC: 0x%x write barrier entry", p)); \
@@ -277,6 +294,7 @@ OopDesc** ObjectHeap::_task_allocation_start;
 unsigned  ObjectHeap::_reserved_memory_deficit;
 unsigned  ObjectHeap::_current_deficit;
 bool      ObjectHeap::_some_tasks_terminated;
+unsigned  ObjectHeap::_terminated_task_memory;
 
 TaskMemoryInfo  ObjectHeap::_task_info [MAX_TASKS];
 
@@ -475,6 +493,7 @@ void ObjectHeap::on_task_termination ( OopDesc* p ) {
   }
 #endif
   _some_tasks_terminated = true;
+  _terminated_task_memory += get_task_info( task_id ).estimate;
   reset_task_memory_usage( task_id );
 #if ENABLE_MEMORY_MONITOR
   notify_task_objects_disposed( task_id );
@@ -1709,6 +1728,13 @@ void ObjectHeap::dispose( void ) {
   _is_gc_active = false;
   _last_heap_expansion_failed = false;
 
+  _tenuring_threshold = 0;
+  _young_generation_age = 0;
+  _promoted_since_full_collect = 0;
+  _last_collect_end_time = 0;
+  _gc_time_percentage = 0;
+  _is_explicit_collect = false;
+
 #ifdef AZZERT
   GCDisabler__disabling_count = 0;
   AllocationDisabler__disabling_count = 0;
@@ -1764,12 +1790,25 @@ bool ObjectHeap::create( void ) {
   _excessive_gc_countdown = 0;
 #endif
 
+  if (TenuringThreshold < 0) {
+    TenuringThreshold = 0;
+  } else if (TenuringThreshold > MaxTenuringThreshold) {
+    TenuringThreshold = MaxTenuringThreshold;
+  }
+  _tenuring_threshold = TenuringThreshold;
+  _young_generation_age = 0;
+  _promoted_since_full_collect = 0;
+  _last_collect_end_time = gc_cost_time_stamp();
+  _gc_time_percentage = 0;
+  _is_explicit_collect = false;
+
 #if ENABLE_ISOLATES
   _current_task_id          = 0;
   _previous_task_id         = SYSTEM_TASK;
   _current_deficit          = 0;
   _reserved_memory_deficit  = 0;
   _some_tasks_terminated    = false;
+  _terminated_task_memory   = 0;
 
   {
     TaskMemoryInfo* p = _task_info;
@@ -2267,11 +2306,11 @@ juint ObjectHeap::mark_and_stack_pointers(OopDesc** p, juint bitword) {
   juint valid = 0;
   int i = 0;
   do {
-    if ((bitword & 0xFFFF) == 0) { bitword >>= 16; i += 16; }
-    if ((bitword &   0xFF) == 0) { bitword >>=  8; i +=  8; }
-    if ((bitword &    0xF) == 0) { bitword >>=  4; i +=  4; }
-    if ((bitword &    0x3) == 0) { bitword >>=  2; i +=  2; }
-    if ((bitword &    0x1) == 0) { bitword >>=  1; i +=  1; }
+    {
+      const int skip = lowest_set_bit(bitword);
+      bitword >>= skip;
+      i += skip;
+    }
 
     if( TraceGC ) {
       TTY_TRACE_CR(("TraceGC: 0x%x write barrier entry", p+i));
@@ -2304,10 +2343,36 @@ juint ObjectHeap::mark_and_stack_pointers(OopDesc** p, juint bitword) {
   return valid;
 }
 
+// The old generation part of the bitvector is mostly clean, so it is
+// scanned RememberedSetScanStride words at a time: a whole group is skipped
+// if none of its words has a bit set, and only the words of a dirty group
+// are examined one by one.
 inline void ObjectHeap::mark_remembered_set(void) {
+  enum { RememberedSetScanStride = 4 };
   OopDesc** p = align_down( _heap_start );
   juint* bitp = get_bitvectorword_for_aligned(p);
   OopDesc** const end = _old_generation_end - BitsPerWord;
+  OopDesc** const stride_end =
+    end - (RememberedSetScanStride - 1) * BitsPerWord;
+  while( p <= stride_end ) {
+    // Constant trip count, compilers unroll this into a chain of ORs
+    juint group = 0;
+    for( int n = 0; n < RememberedSetScanStride; n++ ) {
+      group |= bitp[n];
+    }
+    if( group == 0 ) {
+      bitp += RememberedSetScanStride;
+      p += RememberedSetScanStride * BitsPerWord;
+      continue;
+    }
+    for( int n = RememberedSetScanStride; --n >= 0;
+         bitp++, p += BitsPerWord ) {
+      const juint bitword = *bitp;
+      if( bitword ) {
+        *bitp = mark_and_stack_pointers(p, bitword);
+      }
+    }
+  }
   for( ; p <= end; bitp++, p += BitsPerWord ) {
     const juint bitword = *bitp;
     if( bitword ) {
@@ -2469,6 +2534,7 @@ inline void ObjectHeap::mark_objects( const bool is_full_collect ) {
 #if ENABLE_ISOLATES
   if( is_full_collect && _some_tasks_terminated ) {
     _some_tasks_terminated = false;
+    _terminated_task_memory = 0;
 #if ENABLE_COMPILER
     cleanup_compiled_method_cache();
 #endif
@@ -2525,12 +2591,77 @@ void ObjectHeap::mark_forward_pointer(OopDesc** p) {
   }
 }
 
+// Returns the first marked location in [p, end), or end if there is none.
+inline OopDesc** ObjectHeap::next_marked( OopDesc** p, OopDesc** end ) {
+  juint* bitvector_word_ptr = get_bitvectorword_for_unaligned(p);
+  const juint* const last_bitvector_word_ptr =
+    get_bitvectorword_for_unaligned(end);
+  const int trash_bits =
+    p - ObjectHeap::get_aligned_for_bitvectorword(bitvector_word_ptr);
+  GUARANTEE(0 <= trash_bits && trash_bits <= 31, "Sanity");
+
+  juint bitword = *bitvector_word_ptr & ~((1 << (trash_bits)) - 1);
+  while (bitword == 0) {
+    if (bitvector_word_ptr >= last_bitvector_word_ptr) {
+      return end;
+    }
+    bitword = *++bitvector_word_ptr;
+  }
+  p = ObjectHeap::get_aligned_for_bitvectorword(bitvector_word_ptr)
+    + lowest_set_bit(bitword);
+  return p < end ? p : end;
+}
+
+// Large arrays (such as I/O buffers) are expensive to slide. If the dead
+// range at p is followed by a live object of at least LargeArrayThreshold
+// bytes, and the dead range is small compared to that object, the dead
+// range is turned into a marked filler object. The large object then
+// stays in the fixed part of the collection area and is not copied.
+inline bool ObjectHeap::fill_dead_wood( OopDesc** p, OopDesc** end ) {
+  const juint percentage = (juint)LargeArrayDeadWoodPercentage;
+  if (LargeArrayThreshold <= 0 || LargeArrayDeadWoodPercentage <= 0) {
+    return false;
+  }
+#if ENABLE_MEMORY_MONITOR
+  if (Arguments::_monitor_memory) {
+    // The filler would show up as an object that was never created
+    return false;
+  }
+#endif
+  OopDesc** const live = next_marked(p, end);
+  if (live >= end) {
+    return false;
+  }
+  const juint gap = DISTANCE(p, live);
+  const juint size = ((OopDesc*)live)->object_size();
+  if (size < (juint)LargeArrayThreshold ||
+      gap > size / 100 * percentage) {
+    return false;
+  }
+
+  if (gap == BytesPerWord) {
+    p[0] = Universe::object_class()->prototypical_near();
+  } else {
+    p[0] = Universe::byte_array_class()->prototypical_near();
+    p[1] = (OopDesc*)(gap - Array::base_offset());
+  }
+  GUARANTEE(((OopDesc*)p)->object_size() == (size_t)gap, "Sanity");
+  set_bit_for(p);
+
+  if (TraceGC) {
+    TTY_TRACE_CR(("TraceGC: 0x%x - 0x%x (size %d) dead wood before 0x%x",
+                  p, live, gap, live));
+  }
+  return true;
+}
+
 inline OopDesc** ObjectHeap::mark_forward_pointers( void ) {
   OopDesc** p = _collection_area_start;
   OopDesc** const inline_allocation_top = _inline_allocation_top;
   OopDesc** const end_scan = inline_allocation_top;
   address bitvector_base = _bitvector_base;
-  while (p < end_scan && test_bit_for(p, bitvector_base)) {
+  while (p < end_scan && (test_bit_for(p, bitvector_base) ||
+                          fill_dead_wood(p, end_scan))) {
     // By marking the pointers in the fixed part of young space, we can
     // just treat it as part of a slightly longer old space.  We really only
     // need to mark pointers to "moving space".  But we don't yet know where
@@ -3195,16 +3326,101 @@ void ObjectHeap::full_collect(JVM_SINGLE_ARG_TRAPS) {
   // application doing System.gc() without understanding what they doing,
   // just in case. So here I'm using compromise which frees up some memory, but
   // does almost nothing in most cases.
+  _is_explicit_collect = true;
   safe_collect(1 JVM_NO_CHECK);
+  _is_explicit_collect = false;
   Thread::clear_current_pending_exception();
   GUARANTEE(_interned_string_near_addr == 
             Universe::interned_string_near()->obj(), "must be the same");
 }
 
+// Called by the scheduler when all threads are waiting and the VM is about to
+// block for idle_time milliseconds (-1 means until an event arrives). If
+// enough data has been promoted since the last full GC, the full GC is done
+// now, so that its pause falls into idle time instead of into a later
+// allocation.
+void ObjectHeap::collect_when_idle(const jlong idle_time) {
+  if (_is_gc_active || !GCDisabler::gc_okay()) {
+    return;
+  }
+  if (idle_time >= 0 && idle_time < (jlong)IdleCollectionMinimumTime) {
+    return;
+  }
+  bool should_collect = IdleCollectionPercentage > 0 &&
+    _promoted_since_full_collect >=
+      _heap_size / 100 * IdleCollectionPercentage;
+#if ENABLE_ISOLATES
+  // Objects of terminated tasks can only be reclaimed by a full GC, so
+  // do it now rather than when the old generation fills up.
+  if (IdleCollectionAfterTaskTermination && _terminated_task_memory > 0) {
+    should_collect = true;
+  }
+#endif
+  if (!should_collect) {
+    return;
+  }
+
+  if (VerboseGC || TraceGC) {
+    TTY_TRACE_CR(("idle GC: %dK promoted since last full GC",
+                  _promoted_since_full_collect / 1024));
+#if ENABLE_ISOLATES
+    TTY_TRACE_CR(("idle GC: %dK used by terminated tasks",
+                  _terminated_task_memory / 1024));
+#endif
+  }
+#if ENABLE_PERFORMANCE_COUNTERS
+  const jlong start_time = Os::elapsed_counter();
+#endif
+
+  SETUP_ERROR_CHECKER_ARG;
+  full_collect(JVM_SINGLE_ARG_NO_CHECK);
+
+  PERFORMANCE_COUNTER_INCREMENT(num_of_idle_gc, 1);
+  PERFORMANCE_COUNTER_INCREMENT(total_idle_gc_hrticks,
+                                Os::elapsed_counter() - start_time);
+}
+
 #if ENABLE_TTY_TRACE
 void print_size(Stream* st, size_t size) {
   st->print("%dK", size/1024);
 }
+
+OopDesc** ObjectHeap::_allocation_histogram_start;
+
+// Prints how many objects (and bytes) of each power-of-two size class
+// were allocated since the previous GC. Use it to tune LargeArrayThreshold.
+void ObjectHeap::print_allocation_histogram(OopDesc** p, OopDesc** to) {
+  enum { MinLogSize = 3, NumOfBuckets = 18 };
+  int count[NumOfBuckets];
+  size_t bytes[NumOfBuckets];
+  jvm_memset(count, 0, sizeof count);
+  jvm_memset(bytes, 0, sizeof bytes);
+
+  while (p < to) {
+    const size_t size = ((OopDesc*)p)->object_size();
+    int bucket = 0;
+    while (bucket < NumOfBuckets - 1 &&
+           size > (size_t)(1 << (bucket + MinLogSize))) {
+      bucket++;
+    }
+    count[bucket]++;
+    bytes[bucket] += size;
+    p = DERIVED(OopDesc**, p, size);
+  }
+
+  tty->print_cr("[allocation sizes since last GC]");
+  for (int i = 0; i < NumOfBuckets; i++) {
+    if (count[i] != 0) {
+      tty->print("  %s%7d bytes: %7d objects, ",
+                 (i == NumOfBuckets - 1) ? "> " : "<=",
+                 (i == NumOfBuckets - 1) ? (1 << (i + MinLogSize - 1))
+                                         : (1 << (i + MinLogSize)),
+                 count[i]);
+      print_size(tty, bytes[i]);
+      tty->cr();
+    }
+  }
+}
 #endif
 
 inline void ObjectHeap::try_to_shrink(int min_free_after_collection) {
@@ -3219,6 +3435,14 @@ inline void ObjectHeap::try_to_shrink(int min_free_after_collection) {
   used_size += _current_deficit;
 #endif
 
+  if (gc_too_costly()) {
+    if (VerboseGC || TraceHeapSize) {
+      TTY_TRACE_CR(("not shrinking heap: GC takes %d%% of the time",
+                    _gc_time_percentage));
+    }
+    return;
+  }
+
   if (used_size < _heap_size) {
     const size_t new_size = align_up(
       OsMemory_heap_reduction_target(_heap_size, used_size, _heap_min) );
@@ -3239,6 +3463,7 @@ inline void ObjectHeap::try_to_shrink(int min_free_after_collection) {
       const bool t = adjust_heap_size(new_size);
       GUARANTEE(t, "heap shrinking should never fail");
       (void)t;
+      PERFORMANCE_COUNTER_INCREMENT(num_of_heap_reductions, 1);
     }
 
     GUARANTEE(_inline_allocation_end <= _compiler_area_start, "Sanity");
@@ -3284,6 +3509,13 @@ void ObjectHeap::try_to_grow(int requested_free_memory,
     requested_free_memory = _young_generation_target_size;
   }
 
+  // If GC takes too large a share of the time, ask for another young
+  // generation on top, so that the heap grows even if there is enough
+  // free memory to satisfy the request.
+  if( gc_too_costly() ) {
+    requested_free_memory += _young_generation_target_size;
+  }
+
   int required_free_memory = requested_free_memory;
 #if ENABLE_ISOLATES
   required_free_memory += _current_deficit;
@@ -3327,11 +3559,16 @@ void ObjectHeap::try_to_grow(int requested_free_memory,
   GUARANTEE(new_heap_size <= (size_t)_heap_capacity, "sanity");
 
   if (VerboseGC || TraceHeapSize) {
-    TTY_TRACE(("growing heap from %d KB to %d KB\n",
+    TTY_TRACE(("growing heap from %d KB to %d KB",
                _heap_size / 1024, new_heap_size / 1024));
+    if (gc_too_costly()) {
+      TTY_TRACE((" (GC takes %d%% of the time)", _gc_time_percentage));
+    }
+    TTY_TRACE_CR((""));
   }
   OopDesc** const old_heap_top = _heap_top;
   if (adjust_heap_size(new_heap_size)) {
+    PERFORMANCE_COUNTER_INCREMENT(num_of_heap_expansions, 1);
     const int delta = DISTANCE(old_heap_top, _heap_top);
     LargeObject::move( delta, old_heap_top );
     compact_and_move_compiler_area( delta );
@@ -3637,6 +3874,16 @@ inline void ObjectHeap::internal_collect_prologue(size_t min_free_after_collecti
   save_java_stack_snapshot();
   Universe::release_gc_dummy();
 
+#if ENABLE_TTY_TRACE
+  if (TraceAllocationSizes) {
+    OopDesc** from = _allocation_histogram_start;
+    if (from < _young_generation_start || from > _inline_allocation_top) {
+      from = _young_generation_start;
+    }
+    print_allocation_histogram(from, _inline_allocation_top);
+  }
+#endif
+
 #if ENABLE_PERFORMANCE_COUNTERS
   _internal_collect_start_time = Os::elapsed_counter();
 #endif
@@ -3688,6 +3935,10 @@ inline void ObjectHeap::internal_collect_epilogue(bool is_full_collect,
   PERFORMANCE_COUNTER_INCREMENT(total_bytes_collected, collected);
   PERFORMANCE_COUNTER_INCREMENT(total_gc_hrticks, elapsed);
   PERFORMANCE_COUNTER_SET_MAX(max_gc_hrticks, elapsed);
+  if (!is_full_collect) {
+    PERFORMANCE_COUNTER_INCREMENT(total_young_gc_hrticks, elapsed);
+    PERFORMANCE_COUNTER_SET_MAX(max_young_gc_hrticks, elapsed);
+  }
 #endif
 
 #if ENABLE_TTY_TRACE
@@ -3779,15 +4030,90 @@ inline void ObjectHeap::internal_collect_epilogue(bool is_full_collect,
   EventLogger::end(EventLogger::GC);
 }
 
+// Decides whether the survivors of a young GC stay in the young generation,
+// where they get another chance to die, or are promoted to the old one.
+inline bool ObjectHeap::keep_survivors_young(const size_t survivor_size,
+                                             const size_t young_size) {
+  if (_tenuring_threshold <= 0) {
+    return survivor_size * 100
+             < young_size * YoungGenerationSurvivalTargetPercentage;
+  }
+  return _young_generation_age < _tenuring_threshold
+      && survivor_size * 100 < young_size * SurvivorSpacePercentage;
+}
+
+// Measures the share of time spent in this GC since the end of the previous
+// one, and folds it into a running average that steers try_to_grow() and
+// try_to_shrink(). The allocation rate enters implicitly: allocating faster
+// means collecting more often.
+// Collections done by full_collect() (System.gc(), idle time, task
+// termination) are not caused by allocation. They are left out of both the
+// GC time and the period, so they neither grow the heap nor dilute the cost
+// of the next allocation-driven collection.
+void ObjectHeap::update_gc_time_percentage(const jlong collect_start_time) {
+  const jlong now = gc_cost_time_stamp();
+  const jlong gc_time = now - collect_start_time;
+  if (_is_explicit_collect) {
+    _last_collect_end_time += gc_time;
+    return;
+  }
+  const jlong period = now - _last_collect_end_time;
+  _last_collect_end_time = now;
+
+  int sample = 100;
+  if (period > gc_time) {
+    sample = (int)(gc_time * 100 / period);
+  }
+  _gc_time_percentage = (_gc_time_percentage * 3 + sample) / 4;
+#if ENABLE_PERFORMANCE_COUNTERS
+  jvm_perf_count.gc_time_percentage = _gc_time_percentage;
+#endif
+}
+
+// If a full GC reclaims much of what was promoted since the previous one,
+// objects were promoted too early: keep them young a little longer.
+// If hardly anything is reclaimed, promote sooner to save copying.
+void ObjectHeap::adjust_tenuring_threshold(const size_t collected) {
+  const size_t promoted = _promoted_since_full_collect;
+  _promoted_since_full_collect = 0;
+  _young_generation_age = 0;
+  if (TenuringThreshold <= 0 || !AdaptiveTenuring || promoted == 0) {
+    return;
+  }
+
+  int threshold = _tenuring_threshold;
+  if (collected > promoted / 2) {
+    if (threshold < MaxTenuringThreshold) {
+      threshold++;
+    }
+  } else if (collected < promoted / 8) {
+    if (threshold > 1) {
+      threshold--;
+    }
+  }
+  if (threshold != _tenuring_threshold) {
+    if (VerboseGC || TraceGC) {
+      TTY_TRACE_CR(("tenuring threshold %d -> %d (promoted %dK, "
+                    "collected %dK)", _tenuring_threshold, threshold,
+                    promoted / 1024, collected / 1024));
+    }
+    _tenuring_threshold = threshold;
+  }
+}
+
 bool ObjectHeap::internal_collect(size_t min_free_after_collection JVM_TRAPS) {
   LargeObject::verify();
 
   JVM_IGNORE_TRAPS;
   internal_collect_prologue(min_free_after_collection);
   _is_gc_active = true;
+  const jlong collect_start_time =
+    GCTimePercentageTarget > 0 ? gc_cost_time_stamp() : 0;
 
   // Evict compiled methods, etc
   const bool is_full_collect = _collection_area_start == _heap_start;
+  const size_t used_before = DISTANCE(_heap_start, _old_generation_end) +
+                   DISTANCE(_young_generation_start, _inline_allocation_top);
 
   // Make bci and pc relative.  Mark bits on stack
   Scheduler::gc_prologue(is_full_collect ? do_nothing
@@ -3827,10 +4153,15 @@ bool ObjectHeap::internal_collect(size_t min_free_after_collection JVM_TRAPS) {
     if (// there is enough free space
            new_free_if_reuse >= min_free_after_collection
         && (int)new_free_if_reuse >= MinimumCompileSpace
-        && (new_size * 100)
-                 < old_size * YoungGenerationSurvivalTargetPercentage) {
+        && keep_survivors_young(new_size, old_size)) {
       reuse_young_generation = true;
     }
+    if (reuse_young_generation) {
+      _young_generation_age++;
+    } else {
+      _young_generation_age = 0;
+      _promoted_since_full_collect += new_size;
+    }
     if ( old_generation_end != _young_generation_start) {
       if (reuse_young_generation) {
         // Change the target location of all the slices.
@@ -3902,6 +4233,14 @@ bool ObjectHeap::internal_collect(size_t min_free_after_collection JVM_TRAPS) {
     Universe::_compilation_abstinence_ticks += compilation_abstinence_ticks;
   }
 #endif
+  if (is_full_collect) {
+    const int collected =
+      int(used_before) - DISTANCE(_heap_start, _inline_allocation_top);
+    adjust_tenuring_threshold(collected > 0 ? collected : 0);
+  }
+  if (GCTimePercentageTarget > 0) {
+    update_gc_time_percentage(collect_start_time);
+  }
   if (is_full_collect && !compiler_area_in_use() ) {
     // Don't shrink the heap during active compilation.
     // At this point we would have temp compiler data structures 
@@ -3959,6 +4298,9 @@ bool ObjectHeap::internal_collect(size_t min_free_after_collection JVM_TRAPS) {
 #endif
 
   set_task_allocation_start( _inline_allocation_top );
+#if ENABLE_TTY_TRACE
+  _allocation_histogram_start = _inline_allocation_top;
+#endif
   verify_layout();
 #if ENABLE_MEMORY_MONITOR
   if(Arguments::_monitor_memory) {
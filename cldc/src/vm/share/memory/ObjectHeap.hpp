@@ -246,6 +246,7 @@ public:
 
   // Collection
   static void full_collect(JVM_SINGLE_ARG_TRAPS);
+  static void collect_when_idle(const jlong idle_time);
   static void safe_collect(size_t min_free_after_collection JVM_TRAPS)
 #if ENABLE_ISOLATES
     ;
@@ -738,6 +739,9 @@ public:
 #endif
 
   static bool is_gc_active(void) { return _is_gc_active; }
+  // Smoothed share of the elapsed time spent in GC, in percent.
+  // Maintained only if GCTimePercentageTarget is set.
+  static int gc_time_percentage(void) { return _gc_time_percentage; }
   static void force_full_collect(void);
   static bool expand_current_compiled_method(int delta);
 
@@ -804,6 +808,8 @@ private:
   static unsigned _reserved_memory_deficit;
   static unsigned _current_deficit;
   static bool     _some_tasks_terminated;
+  // Memory used by tasks terminated since the last full GC
+  static unsigned _terminated_task_memory;
 
   static TaskMemoryInfo _task_info [MAX_TASKS];
 
@@ -879,6 +885,8 @@ private:
   static void update_interior_pointer_delimited(OopDesc** p);
   static void mark_forward_pointer(OopDesc** p);
   static OopDesc** mark_forward_pointers();
+  static OopDesc** next_marked(OopDesc** p, OopDesc** end);
+  static bool fill_dead_wood(OopDesc** p, OopDesc** end);
 
   static void update_moving_object_interior_pointers(OopDesc** p);
   static void update_moving_object_near_pointer(OopDesc** p);
@@ -1043,6 +1051,26 @@ private:
 
   static bool      _last_heap_expansion_failed;
 
+  // Survivor aging
+  enum { MaxTenuringThreshold = 15 };
+  static int       _tenuring_threshold;
+  static int       _young_generation_age;
+  static size_t    _promoted_since_full_collect;
+  static bool keep_survivors_young(const size_t survivor_size,
+                                   const size_t young_size);
+  static void adjust_tenuring_threshold(const size_t collected);
+
+  // GC cost tracking
+  static jlong     _last_collect_end_time;
+  static int       _gc_time_percentage;
+  // True while full_collect() runs, its collections are not counted
+  static bool      _is_explicit_collect;
+  static void update_gc_time_percentage(const jlong collect_start_time);
+  static bool gc_too_costly(void) {
+    return GCTimePercentageTarget > 0
+        && _gc_time_percentage > GCTimePercentageTarget;
+  }
+
 #if ENABLE_COMPILER
   static OopDesc** _saved_compiler_area_top;
 #endif
@@ -1063,6 +1091,11 @@ private:
   static OopDesc** _saved_compiler_area_top_quick;
 #endif
 
+#if ENABLE_TTY_TRACE
+  static OopDesc** _allocation_histogram_start;
+  static void print_allocation_histogram(OopDesc** from, OopDesc** to);
+#endif
+
 #if ENABLE_PERFORMANCE_COUNTERS || ENABLE_TTY_TRACE || USE_DEBUG_PRINTING
   static jlong  _internal_collect_start_time;
   static size_t _old_gen_size_before;
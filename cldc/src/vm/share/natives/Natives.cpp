@@ -658,6 +658,18 @@ void Java_com_sun_cldchi_jvm_JVM_cancelImageCreation(JVM_SINGLE_ARG_TRAPS) {
 #endif
 }
 
+// public static native void forkWorkers();
+void Java_com_sun_cldchi_jvm_JVM_forkWorkers(JVM_SINGLE_ARG_TRAPS) {
+  JVM_IGNORE_TRAPS;
+#if SUPPORTS_PREFORK
+  int exit_code;
+  if (Os::prefork_workers(&exit_code)) {
+    // The workers have run the application in this parent's stead
+    JVM::stop(exit_code);
+  }
+#endif
+}
+
 // java.lang.Runtime natives
 
 // private native void exitInternal(int status);
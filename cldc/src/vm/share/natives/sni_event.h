@@ -63,6 +63,8 @@ typedef enum SNIsignalType {
     MEDIA_PREPARE_SIGNAL,
     MEDIA_READ_SIGNAL,
     MEDIA_WRITE_SIGNAL,
+    OFFLOAD_SIGNAL,
+    ISOLATE_CHANNEL_SIGNAL,
 } SNIsignalType;
 
 /**
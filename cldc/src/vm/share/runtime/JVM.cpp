@@ -757,6 +757,7 @@ bool JVM::start_standalone_rom_generator(JVM_SINGLE_ARG_TRAPS) {
     int flags = 0;    
     flags |= RemoveConvertedClassFiles ? JVM_REMOVE_CLASSES_FROM_JAR : 0;
     flags |= GenerateSharedROMImage ? JVM_GENERATE_SHARED_IMAGE : 0;
+    flags |= InitializeConvertedClasses ? JVM_INITIALIZE_CLASSES : 0;
 
     get_binary_romizer_args(&input, &output JVM_CHECK_0);
 
@@ -1157,6 +1158,7 @@ extern "C" jint JVM_CreateAppImage(const JvmPathChar *jarFile,
  
   RemoveConvertedClassFiles = (flags & JVM_REMOVE_CLASSES_FROM_JAR) != 0;
   GenerateSharedROMImage = (flags & JVM_GENERATE_SHARED_IMAGE) != 0;  
+  InitializeConvertedClasses = (flags & JVM_INITIALIZE_CLASSES) != 0;
 
   jint code = JVM::start();
 
@@ -1165,6 +1167,7 @@ extern "C" jint JVM_CreateAppImage(const JvmPathChar *jarFile,
 
   GenerateROMImage = false;
   GenerateSharedROMImage = false;
+  InitializeConvertedClasses = false;
 
   return code;
 }
@@ -1342,6 +1345,8 @@ void JVM::print_performance_counters() {
   // Thread counters
   //
   P_INT(T, "num_of_threads at exit",pc->num_of_threads);
+  P_INT(T, "num_of_slow_monitor_enters", pc->num_of_slow_monitor_enters);
+  P_INT(T, "num_of_monitor_contentions", pc->num_of_monitor_contentions);
   P_INT(A, "num_of_timer_ticks",    pc->num_of_timer_ticks, "%9d");
   if (pc->num_of_timer_ticks > 0) {
     jdouble ms_per_tick = jvm_ddiv(msec_scale(elapsed),
@@ -1366,6 +1371,13 @@ void JVM::print_performance_counters() {
 
   P_HRT(A, "total_gc_hrticks",      pc->total_gc_hrticks);
   P_HRT(G, "max_gc_hrticks",        pc->max_gc_hrticks);
+  P_HRT(G, "total_young_gc_hrticks",pc->total_young_gc_hrticks);
+  P_HRT(G, "max_young_gc_hrticks",  pc->max_young_gc_hrticks);
+  P_INT(G, "num_of_idle_gc",        pc->num_of_idle_gc);
+  P_HRT(G, "total_idle_gc_hrticks", pc->total_idle_gc_hrticks);
+  P_INT(G, "num_of_heap_expansions",pc->num_of_heap_expansions);
+  P_INT(G, "num_of_heap_reductions",pc->num_of_heap_reductions);
+  P_INT(G, "gc_time_percentage",    pc->gc_time_percentage);
   P_CR (G);
 
   // Other counters
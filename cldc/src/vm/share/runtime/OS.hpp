@@ -115,6 +115,17 @@ class Os {
   static void resume_profiler()  {}
 #endif
 
+#if SUPPORTS_PREFORK
+  // Called through com.sun.cldchi.jvm.JVM.forkWorkers() once the
+  // application has warmed up. Forks PreforkWorkers copies of the VM,
+  // which continue running the application. Returns false in a worker (or
+  // if no worker could be forked). Returns true in the supervising parent
+  // once the workers are done, with the first failure of a worker (its exit
+  // code, or 128 + signal) in exit_code; the parent must not execute Java
+  // code any more.
+  static bool prefork_workers(int* exit_code);
+#endif
+
   // Start the timer for suspending compilation that takes a long time.
   static void start_compiler_timer();
 
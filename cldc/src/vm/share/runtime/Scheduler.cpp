@@ -43,6 +43,11 @@ OopDesc*   Scheduler::_gc_current_thread = NULL;
 
 int        Scheduler::_estimated_event_readiness = 0;
 bool       Scheduler::_timer_has_ticked = false;
+// Lower bound of the wakeup_time of all waiting threads, 0 if none of
+// them has a timeout. It may be stale (too early) after a timed waiter
+// has been woken up by other means; it is recomputed in
+// wake_up_timed_out_sleepers().
+jlong      Scheduler::_next_wakeup_time = 0;
 bool       Scheduler::_slave_mode_yielding = false;
 jlong      Scheduler::_slave_mode_timeout = -2;
 const char Scheduler::lowbits[16] = {1,1,2,1,3,1,2,1,4,1,2,1,3,1,2,1};
@@ -75,6 +80,98 @@ Scheduler::sched_priority[TASK_PRIORITY_SCALE_MAX][Task::PRIORITY_MAX+1] =
    {0, 3, 21, 76}};
 
 unsigned int Scheduler::_task_execute_counts[Task::PRIORITY_MAX+1];
+
+// CPU time used by each task, and the same time divided by the task
+// priority. The latter is used by TaskCPUFairScheduling to give each
+// runnable task a share of the CPU proportional to its priority.
+jlong Scheduler::_task_cpu_time[MAX_TASKS];
+jlong Scheduler::_task_virtual_time[MAX_TASKS];
+jlong Scheduler::_last_cpu_time_stamp = 0;
+int   Scheduler::_charged_task_id = Task::SYSTEM_TASK;
+
+inline static jlong cpu_time_stamp() {
+#if USE_HIGH_RESOLUTION_TIMER
+  return Os::elapsed_counter();
+#else
+  return Os::java_time_millis();
+#endif
+}
+
+inline static jlong millis_to_cpu_time(const jlong millis) {
+#if USE_HIGH_RESOLUTION_TIMER
+  return millis * Os::elapsed_frequency() / 1000;
+#else
+  return millis;
+#endif
+}
+
+void Scheduler::charge_task_cpu_time(const int next_task_id) {
+  const jlong now = cpu_time_stamp();
+  const int tid = _charged_task_id;
+  if (_last_cpu_time_stamp != 0 && now > _last_cpu_time_stamp) {
+    const jlong elapsed = now - _last_cpu_time_stamp;
+    _task_cpu_time[tid] += elapsed;
+    Task::Raw task = Task::get_task(tid);
+    if (tid != Task::SYSTEM_TASK && task.not_null() && task().priority() > 0) {
+      _task_virtual_time[tid] +=
+        elapsed * Task::PRIORITY_MAX / task().priority();
+    }
+  }
+  _last_cpu_time_stamp = now;
+  _charged_task_id = next_task_id;
+}
+
+void Scheduler::reset_task_cpu_time(const int task_id) {
+  _task_cpu_time[task_id] = 0;
+  _task_virtual_time[task_id] = 0;
+}
+
+jlong Scheduler::task_cpu_time(const int task_id) {
+  const jlong time = _task_cpu_time[task_id];
+#if USE_HIGH_RESOLUTION_TIMER
+  return time * 1000 / Os::elapsed_frequency();
+#else
+  return time;
+#endif
+}
+
+// Returns the virtual time beyond which a task is passed over as long as
+// other tasks with runnable threads lag behind it. Tasks that have been
+// idle for a while (or have just been started) are first brought up to
+// within TaskCPUTimeSlice of the task that has run the most, so they
+// cannot monopolize the CPU while catching up.
+jlong Scheduler::task_virtual_time_limit() {
+  const jlong slice = millis_to_cpu_time(TaskCPUTimeSlice);
+  jlong min_time = max_jlong;
+  jlong max_time = min_jlong;
+  int tid;
+  for (tid = Task::FIRST_TASK; tid < MAX_TASKS; tid++) {
+    Task::Raw task = Task::get_task(tid);
+    if (task.is_null() || task().priority_queue_valid() == 0) {
+      continue;
+    }
+    const jlong time = _task_virtual_time[tid];
+    if (time < min_time) {
+      min_time = time;
+    }
+    if (time > max_time) {
+      max_time = time;
+    }
+  }
+  if (min_time > max_time) {
+    // No runnable tasks
+    return max_jlong;
+  }
+  if (min_time < max_time - slice) {
+    min_time = max_time - slice;
+    for (tid = Task::FIRST_TASK; tid < MAX_TASKS; tid++) {
+      if (_task_virtual_time[tid] < min_time) {
+        _task_virtual_time[tid] = min_time;
+      }
+    }
+  }
+  return min_time + slice;
+}
 #endif
 
 inline ReturnOop Scheduler::find_waiting_thread(Oop* obj) {
@@ -426,7 +523,8 @@ void Scheduler::sleep_forever() {
 /*
  * Universe::scheduler_waiting() is a thread object that serves as
  * the head of a linked list of threads waiting.  Threads pointed at
- * by the _next pointer in this head thread are sleeping.  If a thread
+ * by the _next pointer in this head thread are sleeping, ordered by
+ * their wakeup time.  If a thread
  * is waiting and it is the first waiter for some object then we add it
  * to the _next_waiting list.  Another thread waiting for same object is
  * linked to first one via _next pointer.  Both lists single linked,
@@ -555,16 +653,20 @@ void Scheduler::add_to_sleeping(Thread* thread) {
   thread->set_status((thread->status() &
                         ~THREAD_NOT_ACTIVE_MASK) | THREAD_SLEEPING);
 #endif
-  // First list is the sleep queue.
+  // First list is the sleep queue. Keep it sorted by wakeup time so
+  // that wake_up_timed_out_sleepers() can stop at the first sleeper
+  // that is not due yet.
+  const jlong wakeup_time = thread->wakeup_time();
   Thread::Raw current = Universe::scheduler_waiting();
   Thread::Raw next = current().next();
-  while(next.not_null()) {
+  while(next.not_null() && next().wakeup_time() <= wakeup_time) {
     current = next;
     next = next().next();
   }
   current().set_next(thread);
-  thread->clear_next();
+  thread->set_next(&next);
   thread->clear_wait_obj();
+  note_wakeup_time(wakeup_time);
 }
 
 #if ENABLE_ISOLATES
@@ -691,18 +793,23 @@ void Scheduler::wake_up_timed_out_sleepers(JVM_SINGLE_ARG_TRAPS) {
 
   // Wake up all sleeping threads that have timed out.
   jlong time = Os::java_time_millis();
+  if (_next_wakeup_time == 0 || time < _next_wakeup_time) {
+    // No timeout has expired yet
+    return;
+  }
   GUARANTEE(Universe::scheduler_waiting() != NULL, "Sleep queue at front");
   UsingFastOops fast_oops;
   Thread::Fast this_waiting, next_waiting;
   Thread::Fast this_thread, next_thread;
+  jlong next_wakeup_time = 0;
   this_waiting = Universe::scheduler_waiting();
   while (!this_waiting.is_null()) {
     next_waiting = this_waiting().next_waiting();
     this_thread = this_waiting;
     while (!this_thread.is_null()) {
       next_thread = this_thread().next();
-      if ((this_thread().wakeup_time()) != 0 && 
-          (time >= this_thread().wakeup_time())) {
+      const jlong wakeup_time = this_thread().wakeup_time();
+      if (wakeup_time != 0 && time >= wakeup_time) {
         if (TraceThreadsExcessive) {
           TTY_TRACE_CR(("wakeup_timed_out_sleepers: signaling thread 0x%x"
                         " (id=%d)", (int)this_thread().obj(),
@@ -710,11 +817,20 @@ void Scheduler::wake_up_timed_out_sleepers(JVM_SINGLE_ARG_TRAPS) {
         }
         remove_waiting_thread(&this_thread);
         notify_wakeup(&this_thread JVM_CHECK);
+      } else if (wakeup_time != 0) {
+        if (next_wakeup_time == 0 || wakeup_time < next_wakeup_time) {
+          next_wakeup_time = wakeup_time;
+        }
+        if (this_waiting.equals(Universe::scheduler_waiting())) {
+          // The rest of the sleep queue is due even later
+          break;
+        }
       }
       this_thread = next_thread;
     }
     this_waiting = next_waiting;
   }
+  _next_wakeup_time = next_wakeup_time;
 }
 
 bool Scheduler::initialize() {
@@ -725,7 +841,10 @@ bool Scheduler::initialize() {
   _async_count = 0;
   _exit_async_pending = 0;
   _priority_queue_valid = 0;
+  _next_wakeup_time = 0;
 #if ENABLE_ISOLATES
+  _last_cpu_time_stamp = 0;
+  _charged_task_id = Task::SYSTEM_TASK;
   if (TaskPriorityScale < 0 || TaskPriorityScale >= TASK_PRIORITY_SCALE_MAX) {
     TaskPriorityScale = TASK_PRIORITY_SCALE_MAX - 1;
   }
@@ -918,6 +1037,7 @@ void Scheduler::wait_for(Thread* thread, jlong timeout) {
     }
   }
   thread->set_wakeup_time(wakeup);
+  note_wakeup_time(wakeup);
 
   if (Thread::current()->equals(thread)) {
     yield();
@@ -1085,28 +1205,15 @@ void Scheduler::yield() {
       slave_mode_wait_for_event_or_timer(0);
     }
   } else {
-    Thread::Raw wait_thrd;
-    Thread::Raw t;
     if (TraceThreadsExcessive) {
       TTY_TRACE_CR(("yield: no runnable threads"));
     }
     while (*get_next_runnable_thread() == NULL) {
       // All threads are waiting for something. Let's sleep until one
-      // of them wakes up.
-      jlong min_wakeup_time = max_jlong;
-      bool sleeper_found = false;
-      wait_thrd = Universe::scheduler_waiting();
-      while (!wait_thrd.is_null()) {
-        t = wait_thrd.obj();
-        while (!t.is_null()) {
-          if (t().wakeup_time() != 0) {
-            min_wakeup_time = min(min_wakeup_time, t().wakeup_time());
-            sleeper_found = true;
-          }
-          t = t().next();
-        }
-        wait_thrd = wait_thrd().next_waiting();
-      }
+      // of them wakes up. If _next_wakeup_time is stale we just wake up
+      // early, and wake_up_timed_out_sleepers() will recompute it.
+      const jlong min_wakeup_time = _next_wakeup_time;
+      const bool sleeper_found = (min_wakeup_time != 0);
 
       // Must check here before calling wait_for_event... since slave mode
       // will return 'true' and we'll never resume other threads
@@ -1135,6 +1242,19 @@ void Scheduler::yield() {
   // the rest will be handled by switch_thread
 }
 
+// Milliseconds to wait until the earliest sleeper is due, or -1 to wait
+// for an event if there are no sleepers.
+inline static jlong time_to_wakeup(const bool sleeper_found,
+                                   const jlong min_wakeup_time) {
+  if (!sleeper_found) {
+    return -1;
+  }
+  const jlong sleep_time = (min_wakeup_time - Os::java_time_millis()) + 1;
+  // Clock has advanced somewhat, but make sure we're not passing
+  // a negative timeout, which means wait forever!
+  return sleep_time < 0 ? 0 : sleep_time;
+}
+
 // return value: true = we have done waiting inside the loop 
 // in Scheduler::yield().
 bool Scheduler::wait_for_event_or_timer(bool sleeper_found,
@@ -1164,19 +1284,29 @@ bool Scheduler::wait_for_event_or_timer(bool sleeper_found,
       // No more threads?, we're probably shutting down (??)
       return true;
     }
-
-    sleep_time = -1;
-  } else {
-    sleep_time = (min_wakeup_time - Os::java_time_millis()) + 1;
-    if (sleep_time < 0) {
-      // Clock has advanced somewhat, but make sure we're not passing
-      // a negative timeout, which means wait forever!
-      sleep_time = 0;
-    }
   }
+  sleep_time = time_to_wakeup(sleeper_found, min_wakeup_time);
 
   if (!is_slave_mode()) {
+    if (Compiler::resume_when_idle(sleep_time)) {
+      // Part of the compilation is left. Only poll for events now, the
+      // threads may have more to do before the compilation is continued.
+      sleep_time = 0;
+    } else {
+      // Idle compilation and collection use up part of the time to wait
+      sleep_time = time_to_wakeup(sleeper_found, min_wakeup_time);
+      ObjectHeap::collect_when_idle(sleep_time);
+      sleep_time = time_to_wakeup(sleeper_found, min_wakeup_time);
+    }
+#if ENABLE_ISOLATES
+    // Charge the time spent waiting to the system task
+    const int tid = _charged_task_id;
+    charge_task_cpu_time(Task::SYSTEM_TASK);
     master_mode_wait_for_event_or_timer(sleep_time);
+    charge_task_cpu_time(tid);
+#else
+    master_mode_wait_for_event_or_timer(sleep_time);
+#endif
   } else {
     slave_mode_wait_for_event_or_timer(sleep_time);
     return true;
@@ -2152,6 +2282,7 @@ Thread *Scheduler::get_next_runnable_thread(Thread *starting_thread) {
   int task_loop_count = 2;
   bool task_quota_exceeded = false;
   int task_priority;
+  jlong virtual_time_limit = max_jlong;
 #endif
   bool thread_quota_exceeded = false;
   int inner_loop_count;
@@ -2163,6 +2294,9 @@ Thread *Scheduler::get_next_runnable_thread(Thread *starting_thread) {
     return (Thread *)&_next_runnable_thread;
   }
 #if ENABLE_ISOLATES
+  if (TaskCPUFairScheduling && Task::get_num_tasks() > 2) {
+    virtual_time_limit = task_virtual_time_limit();
+  }
   do {
     int start_tid;
     task = Task::current()->obj();
@@ -2193,6 +2327,12 @@ Thread *Scheduler::get_next_runnable_thread(Thread *starting_thread) {
           task_quota_exceeded = true;
           continue;
         }
+        if (_task_virtual_time[tid] > virtual_time_limit) {
+          // This task has had more than its share of CPU time compared
+          // to other runnable tasks.
+          task_quota_exceeded = true;
+          continue;
+        }
       }
       // create local copy of variables
       priority_queue_valid = task().priority_queue_valid();
@@ -2319,6 +2459,7 @@ Thread *Scheduler::get_next_runnable_thread(Thread *starting_thread) {
     if (task_quota_exceeded) {
       task_quota_exceeded = false;
       reset_task_counts();
+      virtual_time_limit = max_jlong;
     } else {
       // Terminate this loop
       task_loop_count = 0;
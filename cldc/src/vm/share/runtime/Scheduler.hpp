@@ -169,6 +169,12 @@ private:
                                    JavaOop *obj);
   static void remove_waiting_thread(Thread* thread);
   static void add_to_sleeping(Thread* thread);
+  static void note_wakeup_time(jlong wakeup_time) {
+    if (wakeup_time != 0 &&
+        (_next_wakeup_time == 0 || wakeup_time < _next_wakeup_time)) {
+      _next_wakeup_time = wakeup_time;
+    }
+  }
   static void wake_up_timed_out_sleepers(JVM_SINGLE_ARG_TRAPS);
   static void check_blocked_threads(jlong timeout);
   static bool wait_for_event_or_timer(bool sleeper_found,
@@ -182,6 +188,11 @@ private:
   static void add_to_suspend(Thread* thread);
   static void remove_from_suspend(Thread* thread);
   static unsigned int _task_execute_counts[];
+  static jlong _task_cpu_time[MAX_TASKS];
+  static jlong _task_virtual_time[MAX_TASKS];
+  static jlong _last_cpu_time_stamp;
+  static int   _charged_task_id;
+  static jlong task_virtual_time_limit();
   static void reset_task_counts() {
     for (int i = 0; i < Task::PRIORITY_MAX+1; i++) {
       _task_execute_counts[i] = 0;
@@ -219,6 +230,7 @@ private:
   static jlong    _slave_mode_timeout;
   static bool     _timer_has_ticked;
   static int      _estimated_event_readiness;
+  static jlong    _next_wakeup_time;
 
 #if ENABLE_PERFORMANCE_COUNTERS
   static jlong    _slave_mode_yield_start_time;
@@ -269,6 +281,14 @@ private:
   // Support for Isolate termination
   static void wake_up_async_threads(int task_id);
   static void wake_up_terminated_sleepers(int task_id JVM_TRAPS);
+
+  // CPU time accounting. The time elapsed since the previous call is
+  // charged to the task that has been running, and next_task_id is
+  // charged from now on.
+  static void charge_task_cpu_time(const int next_task_id);
+  static void reset_task_cpu_time(const int task_id);
+  // Returns the CPU time used by the task in milliseconds
+  static jlong task_cpu_time(const int task_id);
 #endif
 
   static Thread * get_next_runnable_thread(Thread *thread = NULL);
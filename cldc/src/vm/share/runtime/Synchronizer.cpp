@@ -117,6 +117,7 @@ bool Synchronizer::enter(Thread* thread, StackLock* stack_lock JVM_TRAPS) {
     
   GUARANTEE(Scheduler::is_in_some_active_queue(thread),
             "must be active thread");
+  PERFORMANCE_COUNTER_INCREMENT(num_of_slow_monitor_enters, 1);
 
   JavaOop::Fast    obj = stack_lock->owner();
   GUARANTEE(obj.not_null(), "Attempting to unlock NULL object");
@@ -160,6 +161,7 @@ bool Synchronizer::enter(Thread* thread, StackLock* stack_lock JVM_TRAPS) {
     // Add THREAD to the list of waiters. 
     GUARANTEE(StackLock::from_java_oop(&obj)->thread() != 
               thread->obj(), "Reentrancy stack lock not allowed");
+    PERFORMANCE_COUNTER_INCREMENT(num_of_monitor_contentions, 1);
     thread->set_wait_stack_lock(stack_lock);
     stack_lock->clear_owner();
     AZZERT_ONLY(stack_lock = (StackLock*)-1); // Not GC Safe
@@ -427,6 +427,7 @@ void Task::cleanup_terminated_task(int id JVM_TRAPS) {
 
     JarFileParser::flush_caches();
     ObjectHeap::on_task_termination(task);
+    IsolateNatives::on_task_termination(id);
     tlist().obj_at_clear(id);
 
     _num_tasks--;
@@ -322,6 +322,7 @@ void Thread::set_current(Thread* value) {
     int tid = value->task_id();
     Task::Raw task = Universe::task_from_id(tid);
     Universe::set_current_task(tid);
+    Scheduler::charge_task_cpu_time(tid);
     // have to be here, not in Universe::set_current_task()
     ObjectHeap::on_task_switch(tid);
 
@@ -514,8 +515,30 @@ void Thread::stack_overflow(Thread *thread, address stack_pointer) {
     } else {
       new_stack_size = old_stack_size + StackSizeIncrement + StackPadding;
     }
+    const jint minimal_stack_size = new_stack_size;
+    {
+      // Each growth copies the whole stack, so grow geometrically, but
+      // never fail where the minimal growth above would have succeeded.
+      // Frames are moved by the size difference, so keep it aligned.
+      const jint geometric_stack_size = (jint)align_size_up(
+          old_stack_size + StackPadding +
+          old_stack_size / 100 * StackGrowthPercentage, BytesPerLong);
+      const jint geometric_stack_limit = min(geometric_stack_size,
+          (jint)align_size_down(StackSizeMaximum, BytesPerLong));
+      if (new_stack_size < geometric_stack_limit) {
+        new_stack_size = geometric_stack_limit;
+      }
+    }
     if (new_stack_size <= StackSizeMaximum) {
-      thread->grow_execution_stack(new_stack_size JVM_NO_CHECK_AT_BOTTOM);
+      if (new_stack_size > minimal_stack_size) {
+        thread->grow_execution_stack(new_stack_size JVM_NO_CHECK);
+        if (!CURRENT_HAS_PENDING_EXCEPTION) {
+          return;
+        }
+        // Not enough memory for the larger stack, try the minimal one.
+        Thread::clear_current_pending_exception();
+      }
+      thread->grow_execution_stack(minimal_stack_size JVM_NO_CHECK_AT_BOTTOM);
     } else {
       // Throw out of memory error and not stack overflow exception
       // since that exception is not part of CLDC 1.0
@@ -234,11 +234,22 @@ int unicode_strlen(const jchar* str);
  *                                from the <jarFile> before this function
  *                                returns.
  *
+ * JVM_INITIALIZE_CLASSES      -- if this flag is defined, the static
+ *                                initializers of the application classes
+ *                                are executed during the conversion, and
+ *                                the classes are saved in the image in the
+ *                                initialized state, with their static fields
+ *                                and the objects reachable from them. The
+ *                                initializers must not depend on the run-time
+ *                                environment (open files, sockets, threads,
+ *                                current time, etc).
+ *
  * JVM_CreateAppImage() returns 0 if successful.
  */
 
 #define JVM_REMOVE_CLASSES_FROM_JAR    (1 << 1)
 #define JVM_GENERATE_SHARED_IMAGE      (1 << 2)
+#define JVM_INITIALIZE_CLASSES         (1 << 3)
 
 jint JVM_CreateAppImage(const JvmPathChar *jarFile, const JvmPathChar *binFile,
                         int flags);
@@ -475,6 +486,10 @@ typedef struct _JVM_PerformanceCounters {
   int num_of_compiler_gc;
   int num_of_full_gc;
   int num_of_threads;
+  int num_of_slow_monitor_enters; /* Number of monitor enters that were not
+                                   * handled by the stack lock fast path */
+  int num_of_monitor_contentions; /* Number of times a thread had to wait
+                                   * for a monitor owned by another thread */
 
   /*
    * Number of timer ticks received during Vm execution
@@ -501,6 +516,18 @@ typedef struct _JVM_PerformanceCounters {
 
   jlong total_gc_hrticks;      /* Total number of hrticks spent inside GC */
   jlong max_gc_hrticks;        /* Number of hrticks spent in the longest GC */
+  jlong total_young_gc_hrticks;/* Total number of hrticks spent inside
+                                * young generation GC */
+  jlong max_young_gc_hrticks;  /* Number of hrticks spent in the longest
+                                * young generation GC */
+  int num_of_idle_gc;          /* Number of full GCs done while all threads
+                                * were waiting */
+  jlong total_idle_gc_hrticks; /* Total number of hrticks spent inside
+                                * idle-time full GC */
+  int num_of_heap_expansions;  /* Number of times the heap was grown */
+  int num_of_heap_reductions;  /* Number of times the heap was shrunk */
+  int gc_time_percentage;      /* Recent GC time as a percentage of the
+                                * elapsed time, see GCTimePercentageTarget */
 
   jlong total_event_checks;    /* Number times of JVMSPI_CheckEvents called */
   jlong total_event_hrticks;   /* Total hrticks spent for reading events */
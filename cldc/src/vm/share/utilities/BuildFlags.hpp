@@ -940,6 +940,9 @@
 // SUPPORTS_PROFILER_CONTROL          Is the Os::profiler_control() API
 //                                    implemented?
 //
+// SUPPORTS_PREFORK                   Is the Os::prefork_workers() API
+//                                    implemented?
+//
 // HOST_LITTLE_ENDIAN                 Is the development host a little-endian
 //                                    architecture?
 
@@ -955,6 +958,10 @@
 #define SUPPORTS_PROFILER_CONTROL 0
 #endif
 
+#ifndef SUPPORTS_PREFORK
+#define SUPPORTS_PREFORK 0
+#endif
+
 #ifndef SUPPORTS_MEMORY_MAPPED_FILES
 #define SUPPORTS_MEMORY_MAPPED_FILES 0
 #endif
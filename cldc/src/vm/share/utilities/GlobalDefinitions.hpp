@@ -1106,6 +1106,21 @@ inline intptr_t bitfield(intptr_t x, int start_bit_no, int field_length) {
   return mask_bits(x >> start_bit_no, right_n_bits(field_length));
 }
 
+// returns the index of the right-most set bit of x (x must not be 0)
+inline int lowest_set_bit(juint x) {
+#if defined(__GNUC__) && __GNUC__ >= 4
+  return __builtin_ctz(x);
+#else
+  int n = 0;
+  if ((x & 0xFFFF) == 0) { x >>= 16; n += 16; }
+  if ((x &   0xFF) == 0) { x >>=  8; n +=  8; }
+  if ((x &    0xF) == 0) { x >>=  4; n +=  4; }
+  if ((x &    0x3) == 0) { x >>=  2; n +=  2; }
+  if ((x &    0x1) == 0) {           n +=  1; }
+  return n;
+#endif
+}
+
 // returns number of bytes sufficient to hold bitmap of the given length
 inline size_t bitmap_size(int length) {
   return ((length - 1) >> LogBitsPerByte) + 1;
@@ -195,6 +195,34 @@ private:
           "If the survival rate in a young GC is smaller than this, "       \
           "do not expand the young generation")                             \
                                                                             \
+  product(int, TenuringThreshold, 0,                                        \
+          "Number of young GCs whose survivors are kept in the young "      \
+          "generation before they are promoted. 0 means survivors are "     \
+          "kept only if YoungGenerationSurvivalTargetPercentage is met")    \
+                                                                            \
+  product(int, SurvivorSpacePercentage, 50,                                 \
+          "If TenuringThreshold is set, survivors stay in the young "       \
+          "generation only while they fill less than this percentage of "   \
+          "it")                                                             \
+                                                                            \
+  product(bool, AdaptiveTenuring, true,                                     \
+          "Adjust the tenuring threshold after each full GC depending on "  \
+          "how much of the promoted data turned out to be garbage")         \
+                                                                            \
+  product(int, IdleCollectionPercentage, 0,                                 \
+          "If positive, do a full GC while all threads are waiting, once "  \
+          "this percentage of the heap has been promoted since the last "   \
+          "full GC. 0 disables idle-time collections")                      \
+                                                                            \
+  product(int, IdleCollectionMinimumTime, 50,                               \
+          "Do an idle-time full GC only if no thread is due to wake up "    \
+          "within this many milliseconds")                                  \
+                                                                            \
+  product(int, GCTimePercentageTarget, 0,                                   \
+          "If positive, grow the heap and do not shrink it while GC takes " \
+          "more than this percentage of the elapsed time. 0 means the "     \
+          "heap is sized from free memory alone")                           \
+                                                                            \
   develop(bool, YoungGenerationAtEndOfHeap, false,                          \
           "Put young generation at end of the heap")                        \
                                                                             \
@@ -214,6 +242,16 @@ private:
           "Dummy objects allocated at bottom of heap ensuring all objects " \
           "move at GC")                                                     \
                                                                             \
+  product(int, LargeArrayThreshold, 16 * 1024,                              \
+          "Size in bytes from which an object is left in place by heap "    \
+          "compaction if the dead space in front of it is small enough "    \
+          "(see LargeArrayDeadWoodPercentage)")                             \
+                                                                            \
+  product(int, LargeArrayDeadWoodPercentage, 10,                            \
+          "Maximum dead space in front of a large object, as percentage "   \
+          "of the object size, that is kept as filler during compaction "   \
+          "instead of copying the object. 0 disables")                      \
+                                                                            \
   product(int, CompilerAreaPercentage, 20,                                  \
           "Maximum percentage of heap to use by JIT compiler")              \
                                                                             \
@@ -285,6 +323,12 @@ private:
   product(int, StackSizeIncrement, 2 * 1024,                                \
           "stack size increment in bytes")                                  \
                                                                             \
+  product(int, StackGrowthPercentage, 50,                                   \
+          "Grow an overflowing stack by at least this percentage of its "   \
+          "current size, so that deep recursion copies the stack only a "   \
+          "logarithmic number of times. 0 means grow by "                   \
+          "StackSizeIncrement only")                                        \
+                                                                            \
   product(int, StackSizeMaximum, 128 * 1024,                                \
           "Max Java stack size in bytes")                                   \
                                                                             \
@@ -373,6 +417,10 @@ private:
           "to compile (in milliseconds.) MaxCompilationTime can be "        \
           "by reimplementing Os::check_compiler_timer()")                   \
                                                                             \
+  product(bool, CompileWhenIdle, false,                                     \
+          "Continue a suspended compilation while all threads are "         \
+          "waiting, instead of in the next timer tick")                     \
+                                                                            \
   product(int, InterpretationLogSize, INTERP_LOG_SIZE,                      \
           "How many elements of _interpretation_log[] to examine during "   \
           "timer tick -- set to 0 to disable interpretation log")           \
@@ -618,6 +666,9 @@ private:
        op(bool, TraceHeapSize, false,                                       \
           "Verbose trace of heap growth/shrinking")                         \
                                                                             \
+       op(bool, TraceAllocationSizes, false,                                \
+          "Print a size histogram of the objects allocated between GCs")    \
+                                                                            \
        op(bool, TraceCompilerGC, false,                                     \
           "Verbose trace of GC in compiler_area")                           \
                                                                             \
@@ -767,6 +818,10 @@ private:
   optional(bool, RemoveConvertedClassFiles, false,                          \
           "Remove converted class files from JAR files in classpath")       \
                                                                             \
+  optional(bool, InitializeConvertedClasses, false,                         \
+          "Run the static initializers of application classes during "      \
+          "conversion and save the initialized classes in the app image")   \
+                                                                            \
   optional(bool, PostponeErrorsUntilRuntime, ENABLE_MONET,                  \
           "Don't abort romizer on an error caused by invalid class file. "  \
           "Instead, produce a valid ROM image that reports this error at "  \
@@ -853,6 +908,22 @@ private:
   product(int, TaskPriorityScale, 1,                                        \
           "Adjusts scaling of priorities between high and low")             \
                                                                             \
+  product(int, IsolateChannelBufferSize, 2 * 1024 * 1024,                   \
+          "Maximum number of bytes queued in one isolate channel, and the " \
+          "maximum message size")                                           \
+                                                                            \
+  product(bool, IdleCollectionAfterTaskTermination, true,                   \
+          "Do a full GC while all threads are waiting if the heap holds "   \
+          "objects of terminated tasks. See IdleCollectionMinimumTime")     \
+                                                                            \
+  product(bool, TaskCPUFairScheduling, false,                               \
+          "Pass over tasks that used more than their priority-weighted "    \
+          "share of CPU time while other tasks are runnable")               \
+                                                                            \
+  product(int, TaskCPUTimeSlice, 20,                                        \
+          "Milliseconds of CPU time a task may run ahead of its share "     \
+          "when TaskCPUFairScheduling is enabled")                          \
+                                                                            \
   develop(int, ProhibitCompiledCIB, 0,                                      \
           "Prohibits compilation if it must include a specific barrier")    \
                                                                             \
@@ -14,6 +14,8 @@ extern "C" {
 #endif
 
 static int JAVACALL_REPORT_LEVEL = JAVACALL_LOGGING_INFORMATION;
+/* Reports written so far */
+static unsigned long log_written = 0;
     
 static int _enable_log_output = 1;
 static int _init_log = 0;
@@ -107,9 +109,19 @@ void javacall_logging_vprintf(int severity, javacall_logging_channel channelID,
 	if (JAVACALL_REPORT_LEVEL <= severity) {
 		javacall_printf(JAVACALL_LOGGING_HEADER, severity, channelID);
 		javacall_vprintf(format, args);
+		log_written++;
 	}
 }
 
+/* Reports are written when they are made, there is nothing to flush */
+void javacall_logging_flush(void) {
+}
+
+void javacall_logging_getStatistics(unsigned long *written, unsigned long *dropped) {
+	*written = log_written;
+	*dropped = 0;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -19,7 +19,14 @@
  * have any questions.
  */
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdarg.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <sys/time.h>
 	 
 #include "javacall_logging.h"
 	 
@@ -27,11 +34,94 @@
 	 extern "C" {
 #endif
 		 
+/*
+ * Reports are not written by the reporting thread. Each thread that
+ * reports gets its own ring of fixed size records, which only that
+ * thread fills and only the writer thread empties, so no lock is taken
+ * on the reporting side. When a ring is full the report is dropped and
+ * counted instead of waiting. The number of records in a ring can be set
+ * with the JAVACALL_LOG_RECORDS environment variable.
+ *
+ * The writer thread is woken up by the first record queued while it is
+ * idle, and then writes records in batches until all rings are empty.
+ * It writes them to stdout, after pending stdio output, or to the file
+ * named by the JAVACALL_LOG_FILE environment variable.
+ *
+ * The message text is formatted by the reporting thread, "%s" arguments
+ * do not outlive the call.
+ *
+ * Errors and critical reports are written by the reporting thread after
+ * the queued reports, so they are not lost if the process crashes right
+ * after them. A child created by fork() has no writer thread, it drops
+ * the reports queued in the parent and starts its own writer thread.
+ */
+
+/* Default number of records in a ring, must be a power of 2 */
+#define LOG_RING_RECORDS 1024
+/* Bounds for JAVACALL_LOG_RECORDS */
+#define LOG_RING_RECORDS_MIN 16
+#define LOG_RING_RECORDS_MAX 65536
+/* Message bytes kept per record, longer messages are truncated */
+#define LOG_TEXT_SIZE 256
+/* Size of the buffer the writer thread collects records in */
+#define LOG_BATCH_SIZE 8192
+
+/* Writer thread is writing records */
+#define LOG_WRITER_BUSY 0
+/* Writer thread waits for the next record */
+#define LOG_WRITER_IDLE 1
+
+typedef struct {
+	javacall_int64 time;
+	short severity;
+	short channel;
+	int length;
+	char text[LOG_TEXT_SIZE];
+} log_record;
+
+typedef struct log_ring {
+	/* Next record to write, only changed by the owner */
+	unsigned int tail;
+	/* Next record to read, only changed by the writer thread */
+	unsigned int head;
+	/* Reports dropped because the ring was full */
+	unsigned int dropped;
+	/* Dropped reports the writer thread already reported */
+	unsigned int dropped_reported;
+	/* Non zero while a thread owns the ring */
+	int owned;
+	struct log_ring *next;
+	log_record records[];
+} log_ring;
+
 	 static int _enable_log_output = 1;
 	 char static outputbuf[256] = {'\0'};
 
 	 static int JAVACALL_REPORT_LEVEL = JAVACALL_REPORT_LEVEL_DEFAULT;
 	 
+/* All rings ever created, rings are reused but never freed */
+static log_ring *log_rings = NULL;
+/* Ring of the current thread */
+static __thread log_ring *log_own_ring = NULL;
+/* Gives the ring back when its thread exits */
+static pthread_key_t log_ring_key;
+static pthread_once_t log_once = PTHREAD_ONCE_INIT;
+/* Serializes the writer thread and the flush at exit */
+static pthread_mutex_t log_drain_lock = PTHREAD_MUTEX_INITIALIZER;
+/* Posted when the writer thread has to look at the rings */
+static sem_t log_wakeup;
+static int log_writer_state = LOG_WRITER_BUSY;
+static int log_writer_started = 0;
+/* Set in a forked child, the next report starts a new writer thread */
+static int log_writer_restart = 0;
+static int log_fd = 1;
+/* Number of records in a ring, a power of 2 */
+static unsigned int log_ring_records = LOG_RING_RECORDS;
+/* Reports written so far, changed with log_drain_lock held */
+static unsigned long log_written = 0;
+static char log_batch[LOG_BATCH_SIZE];
+static int log_batch_length = 0;
+
 	 /**
 	 * Prints out a string to a system specific output stream
 	 *
@@ -68,6 +158,338 @@
 		 return JAVACALL_REPORT_LEVEL;
 	 }
 	 
+static void log_write(const char *buf, int length) {
+	while (length > 0) {
+		int n = write(log_fd, buf, length);
+		if (n <= 0) {
+			return;
+		}
+		buf += n;
+		length -= n;
+	}
+}
+
+static void log_batch_flush() {
+	if (log_batch_length == 0) {
+		return;
+	}
+	/* Keep the order of reports and System.out output on the console */
+	if (log_fd == 1) {
+		fflush(stdout);
+	}
+	log_write(log_batch, log_batch_length);
+	log_batch_length = 0;
+}
+
+static void log_batch_append(const char *buf, int length) {
+	if (log_batch_length + length > LOG_BATCH_SIZE) {
+		log_batch_flush();
+	}
+	memcpy(log_batch + log_batch_length, buf, length);
+	log_batch_length += length;
+}
+
+static void log_batch_append_report(javacall_int64 time, int severity,
+	int channel, const char *text, int length) {
+	char header[64];
+	int n = snprintf(header, sizeof(header), "%lld.%03d ",
+		(long long)(time / 1000), (int)(time % 1000));
+	n += snprintf(header + n, sizeof(header) - n,
+		JAVACALL_LOGGING_HEADER, severity, channel);
+
+	log_batch_append(header, n);
+	log_batch_append(text, length);
+}
+
+static javacall_int64 log_time() {
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return (javacall_int64)tv.tv_sec * 1000 + tv.tv_usec / 1000;
+}
+
+/*
+ * Formats and writes all records queued so far, must be called with
+ * log_drain_lock held.
+ *
+ * @return number of records written
+ */
+static int log_drain() {
+	char header[64];
+	int count = 0;
+	log_ring *ring;
+
+	for (ring = __atomic_load_n(&log_rings, __ATOMIC_ACQUIRE);
+		ring != NULL; ring = ring->next) {
+		unsigned int head = ring->head;
+		unsigned int tail = __atomic_load_n(&ring->tail, __ATOMIC_ACQUIRE);
+		unsigned int dropped;
+
+		while (head != tail) {
+			log_record *r = &ring->records[head & (log_ring_records - 1)];
+			log_batch_append_report(r->time, r->severity, r->channel,
+				r->text, r->length);
+			head++;
+			count++;
+		}
+
+		/* Let the owner reuse the records only after they were copied */
+		__atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+
+		dropped = __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+		if (dropped != ring->dropped_reported) {
+			int n = snprintf(header, sizeof(header),
+				"JC: %u log reports dropped\n", dropped - ring->dropped_reported);
+			log_batch_append(header, n);
+			ring->dropped_reported = dropped;
+		}
+	}
+
+	log_batch_flush();
+	log_written += count;
+	return count;
+}
+
+static void *log_writer(void *arg) {
+	for (;;) {
+		int count;
+
+		/* Records queued while writing form the next batch */
+		pthread_mutex_lock(&log_drain_lock);
+		count = log_drain();
+		pthread_mutex_unlock(&log_drain_lock);
+		if (count > 0) {
+			continue;
+		}
+
+		/*
+		 * Announce the sleep before looking again, a record added after
+		 * the look then posts the semaphore.
+		 */
+		__atomic_store_n(&log_writer_state, LOG_WRITER_IDLE, __ATOMIC_SEQ_CST);
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+		pthread_mutex_lock(&log_drain_lock);
+		count = log_drain();
+		pthread_mutex_unlock(&log_drain_lock);
+
+		if (count == 0) {
+			while (sem_wait(&log_wakeup) != 0) {
+			}
+		}
+
+		__atomic_store_n(&log_writer_state, LOG_WRITER_BUSY, __ATOMIC_SEQ_CST);
+	}
+
+	return NULL;
+}
+
+static void log_flush_at_exit() {
+	pthread_mutex_lock(&log_drain_lock);
+	log_drain();
+	pthread_mutex_unlock(&log_drain_lock);
+}
+
+static void log_release_ring(void *ring) {
+	__atomic_store_n(&((log_ring *)ring)->owned, 0, __ATOMIC_RELEASE);
+}
+
+static void log_start_writer() {
+	pthread_t tid;
+	pthread_attr_t attr;
+
+	if (pthread_attr_init(&attr) == 0) {
+		if (pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED) == 0 &&
+			pthread_create(&tid, &attr, log_writer, NULL) == 0) {
+			__atomic_store_n(&log_writer_started, 1, __ATOMIC_RELEASE);
+		}
+		pthread_attr_destroy(&attr);
+	}
+}
+
+/* Writes out the queued reports, so that the child does not see them */
+static void log_before_fork() {
+	pthread_mutex_lock(&log_drain_lock);
+	log_drain();
+}
+
+static void log_after_fork_parent() {
+	pthread_mutex_unlock(&log_drain_lock);
+}
+
+/*
+ * Only the forking thread exists in the child. Reports queued by other
+ * threads since log_before_fork() are written by the parent, and the
+ * rings of the other threads are free for reuse.
+ */
+static void log_after_fork_child() {
+	log_ring *ring;
+
+	for (ring = log_rings; ring != NULL; ring = ring->next) {
+		ring->head = ring->tail;
+		ring->dropped_reported = ring->dropped;
+		if (ring != log_own_ring) {
+			ring->owned = 0;
+		}
+	}
+
+	sem_destroy(&log_wakeup);
+	sem_init(&log_wakeup, 0, 0);
+	log_writer_state = LOG_WRITER_BUSY;
+	log_writer_restart = log_writer_started;
+	log_writer_started = 0;
+	pthread_mutex_unlock(&log_drain_lock);
+}
+
+static void log_init() {
+	const char *file = getenv("JAVACALL_LOG_FILE");
+	const char *records = getenv("JAVACALL_LOG_RECORDS");
+
+	if (records != NULL) {
+		long n = strtol(records, NULL, 10);
+		if (n > LOG_RING_RECORDS_MAX) {
+			n = LOG_RING_RECORDS_MAX;
+		}
+		log_ring_records = LOG_RING_RECORDS_MIN;
+		while (log_ring_records < n) {
+			log_ring_records <<= 1;
+		}
+	}
+
+	if (file != NULL) {
+		int fd = open(file, O_WRONLY | O_CREAT | O_APPEND, 0644);
+		if (fd >= 0) {
+			log_fd = fd;
+		}
+	}
+
+	pthread_key_create(&log_ring_key, log_release_ring);
+	sem_init(&log_wakeup, 0, 0);
+	log_start_writer();
+
+	pthread_atfork(log_before_fork, log_after_fork_parent,
+		log_after_fork_child);
+	atexit(log_flush_at_exit);
+}
+
+/*
+ * Finds the ring of the current thread, taking over a ring left by an
+ * exited thread or creating a new one.
+ */
+static log_ring *log_get_ring() {
+	log_ring *ring = log_own_ring;
+
+	if (ring != NULL) {
+		return ring;
+	}
+
+	for (ring = __atomic_load_n(&log_rings, __ATOMIC_ACQUIRE);
+		ring != NULL; ring = ring->next) {
+		int free_ring = 0;
+		if (__atomic_compare_exchange_n(&ring->owned, &free_ring, 1, 0,
+				__ATOMIC_ACQUIRE, __ATOMIC_RELAXED)) {
+			break;
+		}
+	}
+
+	if (ring == NULL) {
+		ring = (log_ring *)calloc(1, sizeof(log_ring) +
+			log_ring_records * sizeof(log_record));
+		if (ring == NULL) {
+			return NULL;
+		}
+		ring->owned = 1;
+		ring->next = __atomic_load_n(&log_rings, __ATOMIC_RELAXED);
+		while (!__atomic_compare_exchange_n(&log_rings, &ring->next, ring, 0,
+				__ATOMIC_RELEASE, __ATOMIC_RELAXED)) {
+		}
+	}
+
+	pthread_setspecific(log_ring_key, ring);
+	log_own_ring = ring;
+	return ring;
+}
+
+/*
+ * Writes a report on the calling thread after all queued reports, and
+ * after pending stdio output that goes to the same file.
+ */
+static void log_report_now(int severity, javacall_logging_channel channelID,
+	const char *format, va_list args) {
+	char text[LOG_TEXT_SIZE];
+	int length = vsnprintf(text, LOG_TEXT_SIZE, format, args);
+
+	if (length < 0) {
+		length = 0;
+	} else if (length >= LOG_TEXT_SIZE) {
+		length = LOG_TEXT_SIZE - 1;
+	}
+
+	pthread_mutex_lock(&log_drain_lock);
+	log_drain();
+	log_batch_append_report(log_time(), severity, channelID, text, length);
+	log_batch_flush();
+	log_written++;
+	pthread_mutex_unlock(&log_drain_lock);
+}
+
+static void log_report(int severity, javacall_logging_channel channelID,
+	const char *format, va_list args) {
+	log_ring *ring;
+	log_record *r;
+	unsigned int head;
+	unsigned int tail;
+	int length;
+
+	pthread_once(&log_once, log_init);
+
+	if (__atomic_load_n(&log_writer_restart, __ATOMIC_RELAXED) &&
+		__atomic_exchange_n(&log_writer_restart, 0, __ATOMIC_ACQ_REL)) {
+		log_start_writer();
+	}
+
+	if (severity >= JAVACALL_LOGGING_ERROR) {
+		log_report_now(severity, channelID, format, args);
+		return;
+	}
+
+	/* Without a ring or a writer thread the report is written right away */
+	ring = log_get_ring();
+	if (ring == NULL || !__atomic_load_n(&log_writer_started, __ATOMIC_ACQUIRE)) {
+		log_report_now(severity, channelID, format, args);
+		return;
+	}
+
+	head = __atomic_load_n(&ring->head, __ATOMIC_ACQUIRE);
+	tail = ring->tail;
+	if (tail - head >= log_ring_records) {
+		__atomic_store_n(&ring->dropped, ring->dropped + 1, __ATOMIC_RELAXED);
+		return;
+	}
+
+	r = &ring->records[tail & (log_ring_records - 1)];
+	r->time = log_time();
+	r->severity = (short)severity;
+	r->channel = (short)channelID;
+	length = vsnprintf(r->text, LOG_TEXT_SIZE, format, args);
+	if (length < 0) {
+		length = 0;
+	} else if (length >= LOG_TEXT_SIZE) {
+		length = LOG_TEXT_SIZE - 1;
+	}
+	r->length = length;
+
+	/* Publish the record before the new tail */
+	__atomic_store_n(&ring->tail, tail + 1, __ATOMIC_RELEASE);
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	if (__atomic_load_n(&log_writer_state, __ATOMIC_RELAXED) == LOG_WRITER_IDLE &&
+		__atomic_exchange_n(&log_writer_state, LOG_WRITER_BUSY, __ATOMIC_RELAXED)
+			== LOG_WRITER_IDLE) {
+		sem_post(&log_wakeup);
+	}
+}
+
 	 /**
 	  * Report a message to the Logging service.
 	  *
@@ -84,6 +506,9 @@
 	  * this method is:
 	  * <code> javacall_logging_printf(severity, chanID, "%s", message); </code>
 	 
+	  * Reports below JAVACALL_LOGGING_ERROR are queued and written by a
+	  * background thread, for them this function never waits for output.
+	  *
 	  * @param severity severity level of report
 	  * @param channelID area report relates to
 	  * @param format detail message to go with the report
@@ -92,19 +517,39 @@
 	 void javacall_logging_printf(int severity, javacall_logging_channel channelID, const char *format, ...) {
 		 if (JAVACALL_REPORT_LEVEL <= severity) {
 			 va_list args;
-			 javacall_printf(JAVACALL_LOGGING_HEADER, severity, channelID);
 			 va_start(args, format);
-			 javacall_vprintf(format, args);
+			 log_report(severity, channelID, format, args);
 			 va_end(args);
 		 }
 	 }
 
 	void javacall_logging_vprintf(int severity, javacall_logging_channel channelID, const char *format, va_list args) {
 		if (JAVACALL_REPORT_LEVEL <= severity) {
-			javacall_printf(JAVACALL_LOGGING_HEADER, severity, channelID);
-			javacall_vprintf(format, args);
+			log_report(severity, channelID, format, args);
 		}
 	}	  
+
+void javacall_logging_flush(void) {
+	pthread_once(&log_once, log_init);
+
+	pthread_mutex_lock(&log_drain_lock);
+	log_drain();
+	pthread_mutex_unlock(&log_drain_lock);
+}
+
+void javacall_logging_getStatistics(unsigned long *written, unsigned long *dropped) {
+	log_ring *ring;
+	unsigned long count = 0;
+
+	pthread_mutex_lock(&log_drain_lock);
+	for (ring = __atomic_load_n(&log_rings, __ATOMIC_ACQUIRE);
+		ring != NULL; ring = ring->next) {
+		count += __atomic_load_n(&ring->dropped, __ATOMIC_RELAXED);
+	}
+	*written = log_written;
+	*dropped = count;
+	pthread_mutex_unlock(&log_drain_lock);
+}
 #ifdef __cplusplus
 	 }
 #endif
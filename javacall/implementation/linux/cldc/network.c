@@ -28,6 +28,7 @@
 #include <pthread.h>
 #include <linux/tcp.h>
 #include <sys/ioctl.h>
+#include <sys/sendfile.h>
 #include <unistd.h>
 
 #define MAXGETHOSTSTRUCT 32
@@ -526,6 +527,78 @@ javacall_result javacall_socket_write_finish(void *handle,
 }
 
 
+/**
+ * Common implementation between sendfile_start() and sendfile_finish().
+ * The file handle is the descriptor returned by javacall_file_open(), so
+ * the kernel can move the data from the page cache to the socket.
+ */
+static int socket_sendfile_common(void *handle,
+                                  javacall_handle file,
+                                  int len,
+                                  int *pBytesWritten){
+
+    int fd = GetFD(handle);
+    ssize_t bytesSent;
+
+	if (IsInvalidFD(fd)) {
+		javacall_logging_printf(JAVACALL_LOGGING_ERROR, JC_NETWORK, "socket_sendfile_common: Invalid handle\n");
+		return JAVACALL_FAIL;
+	}
+
+    bytesSent = sendfile(fd, (int)file, NULL, len);
+    javacall_logging_printf(JAVACALL_LOGGING_INFORMATION, JC_NETWORK, "socket_sendfile_common(): sent %d of %d\n", (int)bytesSent, len);
+
+    if (bytesSent != -1) {
+        *pBytesWritten = (int)bytesSent;
+        return JAVACALL_OK;
+    }
+
+    if (errno == EWOULDBLOCK) {
+        if (set_event_observer(handle, EVENT_FD_WRITE)) {
+			return JAVACALL_FAIL;
+		}
+        return JAVACALL_WOULD_BLOCK;
+    }
+
+    if (errno == EINTR){
+        return JAVACALL_INTERRUPTED;
+    }
+
+    if (errno == EINVAL || errno == ENOSYS) {
+        /* The file cannot be mapped, nothing was sent */
+        return JAVACALL_NOT_IMPLEMENTED;
+    }
+
+    return JAVACALL_FAIL;
+}
+
+/**
+ * See javacall_socket.h for definition.
+ */
+javacall_result javacall_socket_sendfile_start(void *handle,
+                                               javacall_handle file,
+                                               int len,
+                                               int *pBytesWritten,
+                                               void **pContext){
+
+    *pContext = NULL;
+    return socket_sendfile_common(handle, file, len, pBytesWritten);
+}
+
+/**
+ * See javacall_socket.h for definition.
+ */
+javacall_result javacall_socket_sendfile_finish(void *handle,
+                                                javacall_handle file,
+                                                int len,
+                                                int *pBytesWritten,
+                                                void *context){
+
+	(void)context;
+    return socket_sendfile_common(handle, file, len, pBytesWritten);
+}
+
+
 /**
  * See pcsl_network.h for definition.
  */
@@ -22,8 +22,81 @@
 extern "C" {
 #endif
 
+#include <pthread.h>
 #include "javacall_os.h"
 
+/* Maximum number of worker threads serving javacall_os_offload() */
+#define OFFLOAD_MAX_WORKERS 4
+/* Maximum number of requests waiting for a worker */
+#define OFFLOAD_QUEUE_SIZE 16
+
+typedef struct {
+    javacall_os_offload_proc proc;
+    void* arg;
+    /* offload_generation when the request was queued */
+    int generation;
+} offload_request;
+
+static offload_request offload_queue[OFFLOAD_QUEUE_SIZE];
+static int offload_head = 0;
+static int offload_count = 0;
+static int offload_workers = 0;
+static int offload_idle_workers = 0;
+static int offload_shutdown = 0;
+/* Changed by javacall_os_dispose(), older requests are not reported */
+static int offload_generation = 0;
+static pthread_mutex_t offload_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t offload_cond = PTHREAD_COND_INITIALIZER;
+
+static void* offload_thrd_func(void* unused) {
+    offload_request request;
+
+    pthread_mutex_lock(&offload_mutex);
+    for (;;) {
+        offload_idle_workers++;
+        while (offload_count == 0 && !offload_shutdown) {
+            pthread_cond_wait(&offload_cond, &offload_mutex);
+        }
+        offload_idle_workers--;
+        if (offload_shutdown) {
+            break;
+        }
+        request = offload_queue[offload_head];
+        offload_head = (offload_head + 1) % OFFLOAD_QUEUE_SIZE;
+        offload_count--;
+        pthread_mutex_unlock(&offload_mutex);
+
+        request.proc(request.arg);
+
+        /*
+         * Notify with the lock held, so that javacall_os_dispose() cannot
+         * complete in between and the VM gets no events after shutdown.
+         */
+        pthread_mutex_lock(&offload_mutex);
+        if (request.generation == offload_generation) {
+            javanotify_os_offload_done(request.arg);
+        }
+    }
+    offload_workers--;
+    pthread_mutex_unlock(&offload_mutex);
+    return NULL;
+}
+
+/* Called with offload_mutex held */
+static void offload_start_worker(void) {
+    pthread_t tid;
+    pthread_attr_t attr;
+
+    if (pthread_attr_init(&attr) != 0) {
+        return;
+    }
+    if (pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED) == 0 &&
+        pthread_create(&tid, &attr, offload_thrd_func, NULL) == 0) {
+        offload_workers++;
+    }
+    pthread_attr_destroy(&attr);
+}
+
 /*
  * Initialize the OS structure.
  * This is where timers and threads get started for the first
@@ -32,7 +105,9 @@ extern "C" {
  *
 */
 void javacall_os_initialize(void){
-    return;
+    pthread_mutex_lock(&offload_mutex);
+    offload_shutdown = 0;
+    pthread_mutex_unlock(&offload_mutex);
 }
 
 
@@ -42,7 +117,16 @@ void javacall_os_initialize(void){
  * all the work that initialize does.
  */
 void javacall_os_dispose(){
-    return;
+    /*
+     * Queued requests are dropped. Idle workers exit now, busy ones when
+     * their request returns, without reporting it.
+     */
+    pthread_mutex_lock(&offload_mutex);
+    offload_shutdown = 1;
+    offload_generation++;
+    offload_count = 0;
+    pthread_cond_broadcast(&offload_cond);
+    pthread_mutex_unlock(&offload_mutex);
 }
 
 /** 
@@ -64,6 +148,35 @@ int javacall_os_set_system_time(javacall_int64 time) {
 	return JAVACALL_NOT_IMPLEMENTED;
 }
 
+/**
+ * Queues proc(arg) for execution on a worker thread. Workers are started
+ * on demand, up to OFFLOAD_MAX_WORKERS, and stay around for later
+ * requests.
+ */
+javacall_result javacall_os_offload(javacall_os_offload_proc proc, void* arg) {
+    javacall_result res = JAVACALL_FAIL;
+
+    pthread_mutex_lock(&offload_mutex);
+    if (!offload_shutdown && offload_count < OFFLOAD_QUEUE_SIZE) {
+        if (offload_idle_workers <= offload_count &&
+            offload_workers < OFFLOAD_MAX_WORKERS) {
+            offload_start_worker();
+        }
+        if (offload_workers > 0) {
+            offload_request* request =
+                &offload_queue[(offload_head + offload_count) % OFFLOAD_QUEUE_SIZE];
+            request->proc = proc;
+            request->arg = arg;
+            request->generation = offload_generation;
+            offload_count++;
+            pthread_cond_signal(&offload_cond);
+            res = JAVACALL_WOULD_BLOCK;
+        }
+    }
+    pthread_mutex_unlock(&offload_mutex);
+    return res;
+}
+
 #ifdef __cplusplus
 }
 #endif
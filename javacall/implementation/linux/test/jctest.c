@@ -33,6 +33,7 @@
 #include <javacall_serial.h>
 #include <javacall_file.h>
 #include "string.h"
+#include <sys/time.h>
 
 #define MSG_BUF_LEN 512
 javacall_handle handle1, handle2;
@@ -76,6 +77,11 @@ int event_enable = 0;
 int comm_enable = 0;
 int fc_enable = 0;
 int network_ex_enable = 1;
+int logging_enable = 1;
+
+#define LOGGING_TEST_REPORTS 100000
+/* Reports made in a row, fits the default log ring */
+#define LOGGING_TEST_BURST 1000
 
 
 javacall_result initialize() {
@@ -355,6 +361,60 @@ javacall_result jctest_network_ex() {
 }
 
 
+static javacall_int64 jctest_time_us() {
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+	return (javacall_int64)tv.tv_sec * 1000000 + tv.tv_usec;
+}
+
+javacall_result jctest_logging() {
+	javacall_int64 start;
+	javacall_int64 reporting = 0;
+	javacall_int64 writing = 0;
+	unsigned long written;
+	unsigned long dropped;
+	unsigned long written_before;
+	unsigned long dropped_before;
+	int level;
+	int i;
+	int j;
+
+	javacall_print("========jctest_logging========\n");
+	level = javacall_logging_getLevel();
+	javacall_logging_setLevel(JAVACALL_LOGGING_INFORMATION);
+	javacall_logging_flush();
+	javacall_logging_getStatistics(&written_before, &dropped_before);
+
+	for (i = 0; i < LOGGING_TEST_REPORTS; i += LOGGING_TEST_BURST) {
+		start = jctest_time_us();
+		for (j = i; j < i + LOGGING_TEST_BURST; j++) {
+			javacall_logging_printf(JAVACALL_LOGGING_INFORMATION, JC_NONE,
+				"jctest_logging report %d of %d: %s\n", j, LOGGING_TEST_REPORTS, "text");
+		}
+		reporting += jctest_time_us() - start;
+
+		/* Until every report of the burst is written or counted as dropped */
+		javacall_logging_flush();
+		writing += jctest_time_us() - start;
+	}
+
+	javacall_logging_getStatistics(&written, &dropped);
+	written -= written_before;
+	dropped -= dropped_before;
+
+	javacall_logging_setLevel(level);
+	javacall_printf("%d reports in bursts of %d, %d ns per report\n",
+		LOGGING_TEST_REPORTS, LOGGING_TEST_BURST,
+		(int)(reporting * 1000 / LOGGING_TEST_REPORTS));
+	javacall_printf("%lu written, %lu dropped, %d written per second\n", written, dropped,
+		(int)(writing > 0 ? written * (javacall_int64)1000000 / writing : 0));
+	if (written + dropped < LOGGING_TEST_REPORTS) {
+		return JAVACALL_FAIL;
+	}
+	return JAVACALL_OK;
+}
+
 javacall_result jctest_comm() {
 	char szStr[128];
 
@@ -514,6 +574,10 @@ void StartJavacallTest() {
 		ok = jctest_network_ex();
 		javacall_printf("jctest_network_ex: %s\n", ok==JAVACALL_OK?"PASSED":"FAILED");
 	}
+	if (logging_enable) {
+		ok = jctest_logging();
+		javacall_printf("jctest_logging: %s\n", ok==JAVACALL_OK?"PASSED":"FAILED");
+	}
 	if (comm_enable) {
 		ok = jctest_comm();
 		javacall_printf("jctest_comm: %s\n", ok==JAVACALL_OK?"PASSED":"FAILED");
@@ -39,6 +39,8 @@ extern void printToUart(char* buffer);
 
 static int _enable_log_output = 1;
 static int JAVACALL_REPORT_LEVEL = JAVACALL_REPORT_LEVEL_DEFAULT;
+/* Reports written so far */
+static unsigned long log_written = 0;
 
 /**
 * Prints out a string to a system specific output stream
@@ -146,9 +148,19 @@ void javacall_logging_vprintf(int severity, javacall_logging_channel channelID,
     if (JAVACALL_REPORT_LEVEL <= severity) {
         javacall_printf(JAVACALL_LOGGING_HEADER, severity, channelID);
         javacall_vprintf(format, args);
+        log_written++;
     }
 }
 
+/* Reports are written when they are made, there is nothing to flush */
+void javacall_logging_flush(void) {
+}
+
+void javacall_logging_getStatistics(unsigned long *written, unsigned long *dropped) {
+    *written = log_written;
+    *dropped = 0;
+}
+
 #ifdef __cplusplus
 }
 #endif
@@ -519,6 +519,42 @@ javacall_result javacall_socket_write_finish(javacall_handle handle,
 }
 
 
+/**
+ * See javacall_socket.h for definition.
+ *
+ * Files are not sent directly on this platform; the caller copies them.
+ */
+javacall_result javacall_socket_sendfile_start(javacall_handle handle,
+                                               javacall_handle file,
+                                               int len,
+                                               int *pBytesWritten,
+                                               void **pContext){
+
+    (void)handle;
+    (void)file;
+    (void)len;
+    (void)pBytesWritten;
+    (void)pContext;
+    return JAVACALL_NOT_IMPLEMENTED;
+}
+
+/**
+ * See javacall_socket.h for definition.
+ */
+javacall_result javacall_socket_sendfile_finish(javacall_handle handle,
+                                                javacall_handle file,
+                                                int len,
+                                                int *pBytesWritten,
+                                                void *context){
+
+    (void)handle;
+    (void)file;
+    (void)len;
+    (void)pBytesWritten;
+    (void)context;
+    return JAVACALL_NOT_IMPLEMENTED;
+}
+
 /**
  * See pcsl_network.h for definition.
  */
@@ -500,6 +500,10 @@ int javacall_os_set_system_time(javacall_int64 time) {
     return JAVACALL_NOT_IMPLEMENTED;
 }
 
+javacall_result javacall_os_offload(javacall_os_offload_proc proc, void* arg) {
+    return JAVACALL_NOT_IMPLEMENTED;
+}
+
 #ifdef __cplusplus
 }
 #endif
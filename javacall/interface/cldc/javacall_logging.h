@@ -167,6 +167,20 @@ void javacall_logging_setLevel(int report_level);
 
 int javacall_logging_getLevel();
 
+/**
+ * Writes out the reports that are queued and not yet written.
+ */
+void javacall_logging_flush(void);
+
+/**
+ * Returns the number of reports written and dropped so far.
+ *
+ * @param written receives the number of reports written
+ * @param dropped receives the number of reports dropped because the
+ *                output could not keep up with them
+ */
+void javacall_logging_getStatistics(unsigned long *written, unsigned long *dropped);
+
 /** @} */
 
 
@@ -88,6 +88,61 @@ int javacall_os_set_system_time(javacall_int64 time);
 
 /** @} */
 
+/** 
+ * @defgroup OptionalOS Optional OS API 
+ * @ingroup OS
+ *
+ * Offloading of blocking native operations to platform worker threads.
+ * A native method that would otherwise block the VM submits the work
+ * with javacall_os_offload() and blocks only the calling Java thread:
+ *
+ *     info = (SNIReentryData*)SNI_GetReentryData(NULL);
+ *     if (info == NULL) {
+ *         ctx = ...;  // native memory, must not refer to the Java heap
+ *         if (javacall_os_offload(do_work, ctx) == JAVACALL_WOULD_BLOCK) {
+ *             SNIEVT_wait(OFFLOAD_SIGNAL, (int)ctx, NULL);
+ *             KNI_ReturnInt(0);
+ *         }
+ *         do_work(ctx);
+ *     } else {
+ *         ctx = (...)info->descriptor;
+ *     }
+ *     // pick up the result from ctx and free it
+ *
+ * @{
+ */
+
+/**
+ * Function executed on a worker thread. It must not call KNI or SNI.
+ */
+typedef void (*javacall_os_offload_proc)(void* arg);
+
+/**
+ * Queues proc(arg) for execution on a platform worker thread. When it
+ * has returned, javanotify_os_offload_done(arg) is called from the worker
+ * thread. Requests not done when javacall_os_dispose() is called are
+ * dropped or not reported.
+ *
+ * @param proc function to execute
+ * @param arg  argument passed to proc, also identifies the request
+ * @retval JAVACALL_WOULD_BLOCK      request queued
+ * @retval JAVACALL_NOT_IMPLEMENTED  no worker threads on this platform,
+ *                                   the caller must run proc(arg) itself
+ * @retval JAVACALL_FAIL             the queue is full, the caller must
+ *                                   run proc(arg) itself
+ */
+javacall_result javacall_os_offload(javacall_os_offload_proc proc, void* arg);
+
+/**
+ * Notifies the VM that an offloaded request has completed.
+ * Implemented by the VM.
+ *
+ * @param arg the argument passed to javacall_os_offload()
+ */
+void javanotify_os_offload_done(void* arg);
+
+/** @} */
+
 /** @} */
 
 #ifdef __cplusplus
@@ -244,8 +244,57 @@ javacall_result javacall_socket_write_start(javacall_handle handle,
 javacall_result javacall_socket_write_finish(javacall_handle handle,
                                             char *pData, int len,
                                             int *pBytesWritten,
-                                            void *context); 
-    
+                                            void *context);
+
+/**
+ * Initiates sending data from a file to a platform-specific TCP socket
+ * without copying it through a caller supplied buffer. The data is taken
+ * from the current position of the file, which advances by the number of
+ * bytes sent.
+ *
+ * @param handle handle of an open connection
+ * @param file handle of a file opened for reading by javacall_file_open()
+ * @param len number of bytes to attempt to send
+ * @param pBytesWritten returns the number of bytes sent after successful
+ *        operation, 0 if the file has no more data; only set if this
+ *        function returns JAVACALL_OK
+ * @param pContext address of a pointer variable to receive the context;
+ *	  it is set only when this function returns JAVACALL_WOULDBLOCK
+ *
+ * @retval JAVACALL_OK              success
+ * @retval JAVACALL_FAIL            if there was an error
+ * @retval JAVACALL_WOULD_BLOCK     if the operation would block
+ * @retval JAVACALL_INTERRUPTED     for an Interrupted IO Exception
+ * @retval JAVACALL_NOT_IMPLEMENTED if the platform cannot send this file
+ *         directly; nothing has been sent and the caller should copy the
+ *         data itself
+ */
+javacall_result javacall_socket_sendfile_start(javacall_handle handle,
+                                               javacall_handle file, int len,
+                                               int *pBytesWritten,
+                                               void **pContext);
+
+/**
+ * Finishes a pending send of file data.
+ *
+ * @param handle handle of an open connection
+ * @param file handle of a file opened for reading by javacall_file_open()
+ * @param len number of bytes to attempt to send
+ * @param pBytesWritten returns the number of bytes sent after successful
+ *        operation, 0 if the file has no more data; only set if this
+ *        function returns JAVACALL_OK
+ * @param context the context returned by sendfile_start
+ *
+ * @retval JAVACALL_OK          success
+ * @retval JAVACALL_FAIL        if there was an error
+ * @retval JAVACALL_WOULD_BLOCK  if the caller must call the finish function again to complete the operation
+ * @retval JAVACALL_INTERRUPTED for an Interrupted IO Exception
+ */
+javacall_result javacall_socket_sendfile_finish(javacall_handle handle,
+                                                javacall_handle file, int len,
+                                                int *pBytesWritten,
+                                                void *context);
+
 /**
  * Initiates the closing of a platform-specific TCP socket.
  *
@@ -785,6 +785,22 @@ public class Protocol extends ConnectionBaseAdapter implements FileConnection {
         return (readBytes > 0) ? readBytes : -1;
     }
 
+    /**
+     * Returns the native handle the input stream reads the file through.
+     *
+     * @return     the native file handle, or <code>0</code> if it is not
+     *             available
+     * @exception  IOException  if the connection is closed.
+     */
+    int getNativeReadHandle() throws IOException {
+
+        checkReadPermission();
+
+        ensureConnected();
+
+        return fileHandler.getNativeReadHandle();
+    }
+
     /**
      * Returns the number of bytes that can be read (or skipped over) from
      * this input stream without blocking by the next caller of a method for
@@ -1368,7 +1384,8 @@ class EscapedUtil {
 /**
  * Input stream for the connection
  */
-class FileConnectionInputStream extends InputStream {
+class FileConnectionInputStream extends InputStream
+    implements NativeFileSource {
 
     /** Pointer to the connection. */
     private Protocol parent;
@@ -1587,6 +1604,25 @@ class FileConnectionInputStream extends InputStream {
         return readSize;
     }
 
+    /**
+     * Returns the native handle of the file the stream reads, so that
+     * natives can send the file data without copying it through the heap.
+     *
+     * @return     the native file handle, or <code>0</code> while the stream
+     *             keeps data for <code>reset</code>
+     * @exception  IOException  if the stream is closed.
+     */
+    public int getNativeReadHandle() throws IOException {
+        ensureOpen();
+
+        // data taken through the handle would bypass the mark buffer
+        if (isReadFromBuffer || markBuf != null) {
+            return 0;
+        }
+
+        return parent.getNativeReadHandle();
+    }
+
     /**
      * Closes this input stream and releases any system resources associated
      * with the stream.
@@ -105,6 +105,16 @@ interface BaseFileHandler {
      */    
     public void closeForReadWrite() throws IOException;
 
+    /**
+     * Returns the native handle of the file open for reading, for natives
+     * that read the file directly. Data read through the handle is skipped
+     * by subsequent read() calls.
+     *
+     * @return the native file handle, or <code>0</code> if the file is not
+     *         open for reading or the platform does not expose the handle
+     */
+    public int getNativeReadHandle();
+
     /**
      * Gets a filtered list of files and directories contained in a directory.
      * The directory is the handler's target as specified in
@@ -562,6 +562,15 @@ class DefaultFileHandler implements BaseFileHandler {
      */    
     public  native void closeForReadWrite() throws IOException;
 
+    /**
+     * Returns the javacall handle of the file open for reading.
+     * @return the read handle, <code>0</code> if the file is not open for
+     *         reading
+     */
+    public int getNativeReadHandle() {
+        return readHandle;
+    }
+
 
     /**
      * Reads data from the file to an array.
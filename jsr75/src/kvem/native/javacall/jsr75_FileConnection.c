@@ -28,6 +28,7 @@
 
 #include <kni.h>
 #include <kni_globals.h>
+#include <sni.h>
 #include <PCSLString_Util.h>
 #include <pcsl_memory.h>
 #include <pcsl_string.h>
@@ -1663,27 +1664,17 @@ Java_com_sun_cldc_io_j2me_file_DefaultFileHandler_read()
 
     if (NULL != handle)
     {
-        data = (jbyte*)pcsl_mem_malloc(length * sizeof(jbyte));
-
-        if (NULL == data)
-        {
-            KNI_ThrowNew(KNIOutOfMemoryError, NULL);
-        }
-        else
+        /*
+         * Read straight into the Java array. Bounds check was performed at
+         * J2ME level, and no GC can happen during javacall_file_read().
+         */
+        KNI_GetParameterAsObject(1, byteArrHandle);
+        data = (jbyte*)SNI_GetRawArrayPointer(byteArrHandle) + offset;
+
+        res = javacall_file_read(handle, (unsigned char *)data, length);
+        if (res < 0)
         {
-            res = javacall_file_read(handle, (unsigned char *)data, length);
-            if (res < 0)
-            {
-                KNI_ThrowNew(KNINullPointerException, EXCEPTION_MSG(fcFileReadFailed));
-            }
-            else
-            {
-                /* Set read data. Bounds check was performed at J2ME level */
-                KNI_GetParameterAsObject(1, byteArrHandle);
-                KNI_SetRawArrayRegion(byteArrHandle, offset * sizeof(jbyte),
-                                      res * sizeof(jbyte), data);
-            }
-            pcsl_mem_free(data);
+            KNI_ThrowNew(KNINullPointerException, EXCEPTION_MSG(fcFileReadFailed));
         }
     }
     else
@@ -1721,27 +1712,17 @@ Java_com_sun_cldc_io_j2me_file_DefaultFileHandler_write()
 
     if (NULL != handle)
     {
-        data = (jbyte*)pcsl_mem_malloc(length * sizeof(jbyte));
-
-        if (NULL == data)
-        {
-			DEBUG_PRINT("File.write() << Error KNIOutOfMemoryError\n");
-            KNI_ThrowNew(KNIOutOfMemoryError, NULL);
-        }
-        else
+        /*
+         * Write straight from the Java array. Bounds check was performed at
+         * J2ME level, and no GC can happen during javacall_file_write().
+         */
+        KNI_GetParameterAsObject(1, byteArrHandle);
+        data = (jbyte*)SNI_GetRawArrayPointer(byteArrHandle) + offset;
+
+        res = javacall_file_write(handle, (unsigned char *)data, length);
+        if (res < 0)
         {
-            /* Get write data. Bounds check was performed at J2ME level */
-            KNI_GetParameterAsObject(1, byteArrHandle);
-            KNI_GetRawArrayRegion(byteArrHandle, offset * sizeof(jbyte),
-                                  length * sizeof(jbyte), data);
-
-            res = javacall_file_write(handle, (unsigned char *)data, length);
-            if (res < 0)
-            {
-                KNI_ThrowNew(KNINullPointerException, EXCEPTION_MSG(fcFileWriteFailed));
-            }
-
-            pcsl_mem_free(data);
+            KNI_ThrowNew(KNINullPointerException, EXCEPTION_MSG(fcFileWriteFailed));
         }
     }
     else
@@ -142,6 +142,37 @@ pcsl_socket_write_finish(void *handle,
 }
 
 
+/**
+ * See pcsl_socket.h for definition.
+ */
+int
+pcsl_socket_sendfile_start(void *handle,
+    void *file, int len, int *pBytesWritten, void **pContext) {
+    javacall_result res;
+
+    res = javacall_socket_sendfile_start(handle, file, len, pBytesWritten, pContext);
+    if (res == JAVACALL_NOT_IMPLEMENTED) {
+        return PCSL_NET_NOTSUPPORTED;
+    }
+
+    return javacall_to_pcsl_result(res);
+}
+
+
+/**
+ * See pcsl_socket.h for definition.
+ */
+int
+pcsl_socket_sendfile_finish(void *handle,
+    void *file, int len, int *pBytesWritten, void *context) {
+    javacall_result res;
+
+    res = javacall_socket_sendfile_finish(handle, file, len, pBytesWritten, context);
+
+    return javacall_to_pcsl_result(res);
+}
+
+
 /**
  * See pcsl_network.h for definition.
  */
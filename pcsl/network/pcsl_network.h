@@ -167,6 +167,12 @@ extern "C" {
  */
 #define PCSL_NET_INVALID -5
 
+/**
+ * Return value indicating that the platform does not support the requested
+ * operation. Nothing has been done and the caller may use a fallback.
+ */
+#define PCSL_NET_NOTSUPPORTED -7
+
 /**
  * A value that is guaranteed to be different from any
  * possible PCSL_NET_* return value.
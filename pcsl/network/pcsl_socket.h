@@ -183,6 +183,61 @@ extern int pcsl_socket_write_finish(
 	void *context); 
 
 
+/**
+ * Initiates sending data from a file to a TCP socket without copying it
+ * through a caller supplied buffer. The data is taken from the current
+ * position of the file, which advances by the number of bytes sent.
+ *
+ * @param handle handle of an open connection
+ * @param file handle of a file opened for reading by javacall_file_open()
+ *        or the platform equivalent
+ * @param len number of bytes to attempt to send
+ * @param pBytesWritten returns the number of bytes sent after successful
+ *        operation, 0 if the file has no more data; only set if this
+ *        function returns PCSL_NET_SUCCESS
+ * @param pContext address of a pointer variable to receive the context;
+ *	  it is set only when this function returns PCSL_NET_WOULDBLOCK
+ *
+ * @return PCSL_NET_SUCCESS for successful operation;\n
+ *       PCSL_NET_WOULDBLOCK if the operation would block,\n
+ *       PCSL_NET_INTERRUPTED for an Interrupted IO Exception\n
+ *       PCSL_NET_NOTSUPPORTED if the platform cannot send the file
+ *       directly and nothing has been sent\n
+ *       PCSL_NET_IOERROR for all other errors
+ */
+extern int pcsl_socket_sendfile_start(
+	void *handle,
+	void *file,
+	int len,
+	int *pBytesWritten,
+	void **pContext);
+
+
+/**
+ * Finishes a pending send of file data.
+ *
+ * @param handle handle of an open connection
+ * @param file handle of a file opened for reading
+ * @param len number of bytes to attempt to send
+ * @param pBytesWritten returns the number of bytes sent after successful
+ *        operation, 0 if the file has no more data; only set if this
+ *        function returns PCSL_NET_SUCCESS
+ * @param context the context returned by sendfile_start
+ *
+ * @return PCSL_NET_SUCCESS for successful operation;\n
+ * PCSL_NET_WOULDBLOCK if the caller must call the finish function again to
+ * complete the operation;\n
+ *       PCSL_NET_INTERRUPTED for an Interrupted IO Exception\n
+ *       PCSL_NET_IOERROR for all other errors
+ */
+extern int pcsl_socket_sendfile_finish(
+	void *handle,
+	void *file,
+	int len,
+	int *pBytesWritten,
+	void *context);
+
+
 /**
  * Initiates the closing of a platform-specific TCP socket.
  *
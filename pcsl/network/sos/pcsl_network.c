@@ -262,6 +262,35 @@ int pcsl_socket_write_finish(
     return PCSL_NET_IOERROR;
 }
 
+
+/**
+ * See pcsl_socket.h for definition.
+ *
+ * Files are not sent directly on this platform; the caller copies them.
+ */
+int pcsl_socket_sendfile_start(
+	void *handle,
+	void *file,
+	int len,
+	int *pBytesWritten,
+	void **pContext)
+{
+    return PCSL_NET_NOTSUPPORTED;
+}
+
+/**
+ * See pcsl_socket.h for definition.
+ */
+int pcsl_socket_sendfile_finish(
+	void *handle,
+	void *file,
+	int len,
+	int *pBytesWritten,
+	void *context)
+{
+    return PCSL_NET_NOTSUPPORTED;
+}
+
 /**
  * See pcsl_network.h for definition.
  */ 
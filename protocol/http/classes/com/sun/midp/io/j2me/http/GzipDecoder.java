@@ -0,0 +1,172 @@
+/*
+ * Copyright (C) Max Mu
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * Please visit www.joshvm.org if you need additional information or
+ * have any questions.
+ */
+
+package com.sun.midp.io.j2me.http;
+
+import java.io.IOException;
+
+/**
+ * Decodes a <code>Content-Encoding: gzip</code> response body. The
+ * compressed body is read from the HTTP connection after the transfer
+ * coding was removed, and is inflated natively straight into the
+ * caller's buffer.
+ */
+class GzipDecoder {
+    /** Size of the compressed data buffer. */
+    private static final int INPUT_BUFFER_SIZE = 4096;
+
+    /** Index of the input bytes consumed by the last inflate call. */
+    private static final int IN_USED = 0;
+    /** Index of the flag set once the gzip trailer was verified. */
+    private static final int DONE = 1;
+
+    /** Connection the compressed body is read from. */
+    private Protocol source;
+    /** Native decoder state, including the inflate window. */
+    private int[] state;
+    /** Compressed data not consumed by the decoder yet. */
+    private byte[] in;
+    /** Offset of the first unconsumed byte in <code>in</code>. */
+    private int inOff;
+    /** Number of unconsumed bytes in <code>in</code>. */
+    private int inLen;
+    /** True once the compressed body ended. */
+    private boolean sourceEof;
+
+    /**
+     * Creates a decoder for the response body of a connection.
+     *
+     * @param source connection to read the compressed body from
+     */
+    GzipDecoder(Protocol source) {
+        this.source = source;
+        state = new int[(stateSize() + 3) >> 2];
+        init(state);
+        in = new byte[INPUT_BUFFER_SIZE];
+    }
+
+    /**
+     * Reads up to <code>len</code> bytes of decoded data.
+     *
+     * @param      b     the buffer into which the data is read.
+     * @param      off   the start offset in array <code>b</code>
+     *                   at which the data is written.
+     * @param      len   the maximum number of bytes to read.
+     * @return     the total number of bytes read into the buffer, or
+     *             <code>-1</code> if there is no more data because the end of
+     *             the stream has been reached.
+     * @exception  IOException  if an I/O error occurs or the data is
+     *             not valid gzip.
+     */
+    int read(byte[] b, int off, int len) throws IOException {
+        if (len == 0) {
+            return 0;
+        }
+
+        for (;;) {
+            int rc = inflate(state, in, inOff, inLen, b, off, len);
+            int used = state[IN_USED];
+
+            inOff += used;
+            inLen -= used;
+
+            if (rc > 0) {
+                return rc;
+            }
+
+            if (state[DONE] != 0) {
+                skipRemaining();
+                return -1;
+            }
+
+            if (used > 0) {
+                continue;
+            }
+
+            // The decoder needs more input to make progress
+            if (sourceEof) {
+                throw new IOException("unexpected end of gzip stream");
+            }
+
+            if (inOff > 0) {
+                System.arraycopy(in, inOff, in, 0, inLen);
+                inOff = 0;
+            }
+
+            rc = source.readBody(in, inLen, in.length - inLen);
+            if (rc < 0) {
+                sourceEof = true;
+            } else {
+                inLen += rc;
+            }
+        }
+    }
+
+    /**
+     * Reads the body past the end of the gzip data, so the connection
+     * sees the end of the response and can be reused.
+     *
+     * @exception  IOException  if an I/O error occurs.
+     */
+    private void skipRemaining() throws IOException {
+        while (!sourceEof) {
+            if (source.readBody(in, 0, in.length) < 0) {
+                sourceEof = true;
+            }
+        }
+
+        inLen = 0;
+    }
+
+    /**
+     * Gets the size of the native decoder state.
+     *
+     * @return size in bytes
+     */
+    private static native int stateSize();
+
+    /**
+     * Resets the decoder state to the start of a gzip stream.
+     *
+     * @param state decoder state
+     */
+    private static native void init(int[] state);
+
+    /**
+     * Decodes as much of the input as fits into the output. The number
+     * of input bytes consumed is left in <code>state[IN_USED]</code>.
+     *
+     * @param state decoder state
+     * @param in compressed data
+     * @param inOff offset of the compressed data
+     * @param inLen number of compressed bytes
+     * @param out buffer for the decoded data
+     * @param outOff offset in the buffer
+     * @param outLen space in the buffer
+     *
+     * @return number of bytes decoded
+     *
+     * @exception IOException if the data is not valid gzip
+     */
+    private static native int inflate(int[] state, byte[] in, int inOff,
+            int inLen, byte[] out, int outOff, int outLen)
+            throws IOException;
+}
@@ -106,12 +106,16 @@ public class Protocol extends ConnectionBaseAdapter
     private static String http_proxy;
     /** Maximum number of persistent connections. */
     private static int maxNumberOfPersistentConnections = 4;
+    /** Maximum number of persistent connections to one host. */
+    private static int maxPersistentConnectionsPerHost = 2;
     /** Connection linger time in the pool, default 60 seconds. */
     private static long connectionLingerTime = 60000;
     /** Persistent connection pool. */
     protected static StreamConnectionPool connectionPool; 
     /** True if com.sun.midp.io.http.force_non_persistent = true. */
     private static boolean nonPersistentFlag;
+    /** False if com.sun.midp.io.http.accept_gzip = false. */
+    private static boolean acceptGzip = true;
 
     /** Get the configuration values for this class. */
     static {
@@ -131,14 +135,57 @@ public class Protocol extends ConnectionBaseAdapter
             nonPersistentFlag = true;
         }
 
+        maxNumberOfPersistentConnections = getPositiveIntProperty(
+            "com.sun.midp.io.http.max_persistent_connections",
+            maxNumberOfPersistentConnections);
+
+        maxPersistentConnectionsPerHost = getPositiveIntProperty(
+            "com.sun.midp.io.http.max_persistent_connections_per_host",
+            maxPersistentConnectionsPerHost);
+
+        connectionLingerTime = getPositiveIntProperty(
+            "com.sun.midp.io.http.persistent_connection_linger_time",
+            (int)connectionLingerTime);
+
+        if ("false".equals(
+                System.getProperty("com.sun.midp.io.http.accept_gzip"))) {
+            acceptGzip = false;
+        }
+
         connectionPool = new StreamConnectionPool(
                                  maxNumberOfPersistentConnections,
+                                 maxPersistentConnectionsPerHost,
                                  connectionLingerTime);
 
         outputDataSize = outputBufferSize - HTTP_OUTPUT_DATA_OFFSET -
                          HTTP_OUTPUT_EXTRA_ROOM;
     }
 
+    /**
+     * Gets a positive integer system property.
+     *
+     * @param key name of the property
+     * @param def value to use if the property is not set or not valid
+     *
+     * @return value of the property or <code>def</code>
+     */
+    private static int getPositiveIntProperty(String key, int def) {
+        String prop = System.getProperty(key);
+
+        if (prop != null) {
+            try {
+                int temp = Integer.parseInt(prop);
+                if (temp > 0) {
+                    return temp;
+                }
+            } catch (NumberFormatException nfe) {
+                // use the default
+            }
+        }
+
+        return def;
+    }
+
     /** The protocol (or scheme) for the URL of the connection. */
     protected String protocol;
     /** Default port number for this protocol. */
@@ -222,6 +269,10 @@ public class Protocol extends ConnectionBaseAdapter
      * pool, forcing an IOException on the read thread.
      */
     private boolean readInProgress;
+    /** True if the request asked for a gzip coded response. */
+    private boolean gzipRequested;
+    /** Decoder of a gzip coded response body or null. */
+    private GzipDecoder gzipIn;
 
     /**
      * Create a new instance of this class and intialize variables.
@@ -377,7 +428,7 @@ public class Protocol extends ConnectionBaseAdapter
     /**
      * Reads up to <code>len</code> bytes of data from the input stream into
      * an array of bytes.
-     * This method reads NonChunked http connection input streams.
+     * A gzip content coding requested by this connection is removed.
      * This method can only be called after the InputStream setup is complete.
      *
      * @param      b     the buffer into which the data is read.
@@ -392,6 +443,30 @@ public class Protocol extends ConnectionBaseAdapter
     protected int readBytes(byte b[], int off, int len)
         throws IOException {
 
+        if (gzipIn != null) {
+            return gzipIn.read(b, off, len);
+        }
+
+        return readBody(b, off, len);
+    }
+
+    /**
+     * Reads up to <code>len</code> bytes of the response body into
+     * an array of bytes, after the transfer coding was removed.
+     * This method reads NonChunked http connection input streams.
+     *
+     * @param      b     the buffer into which the data is read.
+     * @param      off   the start offset in array <code>b</code>
+     *                   at which the data is written.
+     * @param      len   the maximum number of bytes to read.
+     * @return     the total number of bytes read into the buffer, or
+     *             <code>-1</code> if there is no more data because the end of
+     *             the stream has been reached.
+     * @exception  IOException  if an I/O error occurs.
+     */
+    int readBody(byte b[], int off, int len)
+        throws IOException {
+
         int rc;
         
         /*
@@ -526,6 +601,13 @@ public class Protocol extends ConnectionBaseAdapter
             return 0;
         }
 
+        /*
+         * The amount of decoded data is not known until it is inflated.
+         */
+        if (gzipIn != null) {
+            return 0;
+        }
+
         /*
          * Regardless of chunked or non-chunked transfers -
          * if data is already buffered return the amount 
@@ -1566,6 +1648,17 @@ public class Protocol extends ConnectionBaseAdapter
             }
         }
 
+        /*
+         * Ask for a compressed response unless the application
+         * negotiates the content coding itself.
+         */
+        gzipRequested = false;
+        if (acceptGzip &&
+                reqProperties.getPropertyIgnoreCase("Accept-Encoding") == null) {
+            setRequestField("Accept-Encoding", "gzip");
+            gzipRequested = true;
+        }
+
         // HTTP 1.0 requests must contain content length for proxies
         if (getRequestProperty("Content-Length") == null) {
             setRequestField("Content-Length", Integer.toString(bytesToWrite));
@@ -2044,6 +2137,7 @@ public class Protocol extends ConnectionBaseAdapter
         String key = null;
         int prevPropIndex = headerFields.size() - 1;
         boolean firstLine = true;
+        boolean gzipCoded = false;
         String value;
         String prevValue = null;
         int index;
@@ -2057,6 +2151,7 @@ public class Protocol extends ConnectionBaseAdapter
         totalbytesread = 0;
         chunkedIn = false;
         eof = false;
+        gzipIn = null;
 
         
         for (;;) {
@@ -2122,6 +2217,11 @@ public class Protocol extends ConnectionBaseAdapter
                 chunkedIn = true;
             }
 
+            if ((key.equalsIgnoreCase("content-encoding")) &&
+                (value.equalsIgnoreCase("gzip"))) {
+                gzipCoded = true;
+            }
+
             /*
              * Update the Content-Length based on the header value.
              */
@@ -2161,6 +2261,32 @@ public class Protocol extends ConnectionBaseAdapter
         if (chunksize == 0) {
             eof = true;
         }
+
+        /*
+         * Remove the content coding we asked for, the application sees
+         * the decoded entity of unknown length.
+         */
+        if (gzipRequested && gzipCoded && !eof) {
+            gzipIn = new GzipDecoder(this);
+            contentLength = -1;
+            removeHeaderFields("content-encoding");
+            removeHeaderFields("content-length");
+        }
+    }
+
+    /**
+     * Removes all response header fields with the given name.
+     *
+     * @param name case-insensitive name of the header field
+     */
+    private void removeHeaderFields(String name) {
+        for (int i = headerFields.size() - 1; i >= 0; i--) {
+            String key = headerFields.getKeyAt(i);
+
+            if (key.equalsIgnoreCase(name)) {
+                headerFields.removeProperty(key);
+            }
+        }
     }
 
     /**
@@ -35,7 +35,8 @@ package com.sun.midp.io.j2me.http;
  * are searched for a match and inactivity.
  *
  * <p> There is a maximum number of simultaneous connections that can be
- * in the pool at any one time. If for some reason there are no matching
+ * in the pool at any one time, and a smaller maximum for each protocol,
+ * host and port. If for some reason there are no matching
  * connections available - a new one may be created (as long as it does not
  * exceed the maximum). If there number of connections in the pool exceeds 
  * the maximum - an adjustment is made to delete unused connections. Once
@@ -43,6 +44,15 @@ package com.sun.midp.io.j2me.http;
  * a new connection an exception is raised. Once a connection is close down
  * a connection must be returned to the pool as inactive for another use.
  *
+ * <p> Eviction is lazy. Connections not used for longer than the linger
+ * time are closed whenever a connection is requested, added or returned
+ * for reuse, not only lingering connections to the requested host. Until
+ * then a lingering connection keeps its socket open, so an application
+ * that stops making requests holds up to the maximum number of idle
+ * sockets until it exits. No timer is used, since CLDC has no daemon
+ * threads and the timer thread would keep the VM from exiting for the
+ * linger time after the last request.
+ *
  * <p> Each individual stream connection stream element (or container) 
  * includes a in-use flag. Once a connection has been taken from the pool its
  * in-use flag is set to (true) and once that is closed its set to (false).
@@ -56,6 +66,7 @@ import java.io.OutputStream;
 import java.io.DataInputStream;
 import java.io.DataOutputStream;
 
+import java.util.Hashtable;
 import java.util.Vector;
 import java.util.Enumeration;
 
@@ -75,10 +86,17 @@ import javax.microedition.io.StreamConnection;
 public class StreamConnectionPool {
     /** How long a connection can linger after its last use. */
     private long m_connectionLingerTime;
-    /** internal connection hash table */
-    private Vector m_connections;
+    /**
+     * Connections keyed by protocol, host and port, each value is a
+     * vector of stream connection elements.
+     */
+    private Hashtable m_connections;
+    /** Number of connections in the pool. */
+    private int m_size;
     /** maximum connections */
     private int m_max_connections;
+    /** maximum connections to the same protocol, host and port */
+    private int m_max_connections_per_host;
 
     /**
      * Create a new instance of this class.
@@ -87,20 +105,24 @@ public class StreamConnectionPool {
      *
      * @param number_of_connections initial number of connections 
      *       must greater than zero.
+     * @param connections_per_host maximum number of connections to the
+     *       same protocol, host and port, must be greater than zero.
      * @param connectionLingerTime how many milliseconds a connection should
      *       stay in the pool after its last use
      */
     StreamConnectionPool(int number_of_connections,
+                         int connections_per_host,
                          long connectionLingerTime) {
         this.m_max_connections = number_of_connections;
+        this.m_max_connections_per_host = connections_per_host;
         this.m_connectionLingerTime = connectionLingerTime;
-        m_connections = new Vector(m_max_connections);
+        m_connections = new Hashtable(m_max_connections);
     }
-    
+
     /**
      * Tries to add a reuseable connection to the connection pool.
-     * Replace any not in use connections to the same host and port.
-     * Will not add to the same host and port in use. Will replace
+     * Will replace the oldest not in use connection to the same
+     * protocol, host and port if the per host limit is reached and the
      * oldest not in use element (if any) if the pool is full.
      * 
      * @param p_protocol            The protocol for the connection
@@ -117,55 +139,47 @@ public class StreamConnectionPool {
     synchronized boolean add(String p_protocol,
             String p_host, int p_port, StreamConnection sc,
             DataOutputStream dos, DataInputStream dis) {
+        String key = getKey(p_protocol, p_host, p_port);
+        Vector cons;
+        StreamConnectionElement oldestNotInUse;
 
-        StreamConnectionElement oldestNotInUse = null;
+        evictLingering();
 
-        // find the last unused element
-        Enumeration cons = m_connections.elements();
-        while (cons.hasMoreElements()) {
-            StreamConnectionElement sce =
-                (StreamConnectionElement)cons.nextElement();
+        cons = (Vector)m_connections.get(key);
+        if (cons != null && cons.size() >= m_max_connections_per_host) {
+            oldestNotInUse = getOldestNotInUse(cons, null);
+            if (oldestNotInUse == null) {
+                return false;
+            }
 
-            if (sce.m_in_use) {
-                if (p_host.equals(sce.m_host) && p_port == sce.m_port) {
-                    return false;
-                }
+            remove(oldestNotInUse);
+        }
 
-                continue;
-            }
+        if (m_size >= m_max_connections) {
+            oldestNotInUse = null;
 
-            // if the connection is a duplicate, delete it
-            if (p_host.equals(sce.m_host) && p_port == sce.m_port) {
-                // no protocol duplicates on host and port
-                sce.close();
-                m_connections.removeElement(sce);
-                break;
-            } else {
-                if (oldestNotInUse == null ||
-                    sce.m_time < oldestNotInUse.m_time) {
-                    // save the oldest not in use, it may be removed later
-                    oldestNotInUse = sce;
-                }
+            Enumeration e = m_connections.elements();
+            while (e.hasMoreElements()) {
+                oldestNotInUse = getOldestNotInUse((Vector)e.nextElement(),
+                                                   oldestNotInUse);
             }
-        }
 
-        /*
-         * first check and see if the maximum number of connections
-         * has been reached - if so delete the first one in the list (FIFO)
-         *   or
-         * if this port and host are already in the pool.
-         */
-        if (m_connections.size() >= m_max_connections) {
             if (oldestNotInUse == null) {
                 return false;
             }
 
-            oldestNotInUse.close();
-            m_connections.removeElement(oldestNotInUse);
+            remove(oldestNotInUse);
+        }
+
+        cons = (Vector)m_connections.get(key);
+        if (cons == null) {
+            cons = new Vector(m_max_connections_per_host);
+            m_connections.put(key, cons);
         }
-     
-        m_connections.addElement(new StreamConnectionElement(p_protocol,
+
+        cons.addElement(new StreamConnectionElement(p_protocol,
                           p_host, p_port, sc, dos, dis));
+        m_size++;
         return true;
     }
     
@@ -176,13 +190,15 @@ public class StreamConnectionPool {
      * @param sce                 The stream connection element to remove
      */
     synchronized void remove(StreamConnectionElement sce) {
-	sce.close();
-        m_connections.removeElement(sce);
+        sce.close();
+        removeElement(sce);
     }
     
     /**
      * get an available connection and set the boolean flag to 
      * true (unavailable) in the connection pool.
+     * The most recently used matching connection is returned since it
+     * is the least likely to have been closed by the server.
      * Also removes any stale connections, since this method gets
      * called more than add or remove.
      *
@@ -195,33 +211,26 @@ public class StreamConnectionPool {
      */
     public synchronized StreamConnectionElement get(
             String p_protocol, String p_host, int p_port) {
-
+        Vector cons;
         StreamConnectionElement result = null;
-        long c_time = System.currentTimeMillis();
-        Enumeration cons = m_connections.elements();
 
-        while (cons.hasMoreElements()) {
+        evictLingering();
+
+        cons = (Vector)m_connections.get(getKey(p_protocol, p_host, p_port));
+        if (cons == null) {
+            return null;
+        }
+
+        for (int i = cons.size() - 1; i >= 0; i--) {
             StreamConnectionElement sce =
-                (StreamConnectionElement)cons.nextElement();
-            
-            if ((c_time - sce.m_time) > m_connectionLingerTime) {
-                if (!sce.m_in_use) {
-                    sce.close();
-                } else {
-                    // signal returnToUse() to close
-                    sce.m_removed = true;
-                }
+                (StreamConnectionElement)cons.elementAt(i);
 
-                m_connections.removeElement(sce);
+            if (sce.m_in_use) {
                 continue;
             }
 
-            if (p_host.equals(sce.m_host) && p_port == sce.m_port &&
-                    p_protocol.equals(sce.m_protocol) && !sce.m_in_use) {
+            if (result == null || sce.m_time > result.m_time) {
                 result = sce;
-
-                // do not break out so old connections can be removed
-                continue;
             }
         }
 
@@ -236,6 +245,7 @@ public class StreamConnectionPool {
      * Return an instance of the stream connection element to the 
      * connection pool so it can be reused. It is done in the method
      * so it can be synchronized with the get method.
+     * Also closes the other connections that lingered too long.
      *
      * @param returned            The stream connection element to return
      */
@@ -249,5 +259,111 @@ public class StreamConnectionPool {
         }
 
         returned.m_time = System.currentTimeMillis();
+        evictLingering();
+    }
+
+    /**
+     * Closes the connections that lingered longer than the linger time.
+     * Connections in use that lingered are only marked, returnForReuse()
+     * closes them. Must be called with the pool locked.
+     */
+    private void evictLingering() {
+        long c_time = System.currentTimeMillis();
+        Enumeration e = m_connections.elements();
+
+        while (e.hasMoreElements()) {
+            Vector cons = (Vector)e.nextElement();
+
+            for (int i = cons.size() - 1; i >= 0; i--) {
+                StreamConnectionElement sce =
+                    (StreamConnectionElement)cons.elementAt(i);
+                long expires = sce.m_time + m_connectionLingerTime;
+
+                if (c_time > expires) {
+                    if (!sce.m_in_use) {
+                        sce.close();
+                    } else {
+                        // signal returnForReuse() to close
+                        sce.m_removed = true;
+                    }
+
+                    cons.removeElementAt(i);
+                    m_size--;
+                }
+            }
+        }
+
+        removeEmptyKeys();
+    }
+
+    /**
+     * Removes an element from the pool without closing it.
+     * Must be called with the pool locked.
+     *
+     * @param sce                 The stream connection element to remove
+     */
+    private void removeElement(StreamConnectionElement sce) {
+        String key = getKey(sce.m_protocol, sce.m_host, sce.m_port);
+        Vector cons = (Vector)m_connections.get(key);
+
+        if (cons == null || !cons.removeElement(sce)) {
+            // already removed
+            return;
+        }
+
+        m_size--;
+        if (cons.isEmpty()) {
+            m_connections.remove(key);
+        }
+    }
+
+    /** Drops the keys that no longer have any connection. */
+    private void removeEmptyKeys() {
+        Enumeration keys = m_connections.keys();
+
+        while (keys.hasMoreElements()) {
+            Object key = keys.nextElement();
+
+            if (((Vector)m_connections.get(key)).isEmpty()) {
+                m_connections.remove(key);
+            }
+        }
+    }
+
+    /**
+     * Finds the element not in use with the oldest last use time.
+     *
+     * @param cons                vector of stream connection elements
+     * @param oldest              oldest element found so far or null
+     *
+     * @return the oldest element not in use or <code>oldest</code>
+     */
+    private static StreamConnectionElement getOldestNotInUse(Vector cons,
+            StreamConnectionElement oldest) {
+        for (int i = 0; i < cons.size(); i++) {
+            StreamConnectionElement sce =
+                (StreamConnectionElement)cons.elementAt(i);
+
+            if (!sce.m_in_use &&
+                    (oldest == null || sce.m_time < oldest.m_time)) {
+                oldest = sce;
+            }
+        }
+
+        return oldest;
+    }
+
+    /**
+     * Builds the pool key of a connection.
+     *
+     * @param p_protocol            The protocol for the connection
+     * @param p_host                The Hostname for the connection
+     * @param p_port                The port number for the connection
+     *
+     * @return key of the connection
+     */
+    private static String getKey(String p_protocol, String p_host,
+                                 int p_port) {
+        return p_protocol + "://" + p_host + ":" + p_port;
     }
 }
@@ -0,0 +1,815 @@
+/*
+ * Copyright (C) Max Mu
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * Please visit www.joshvm.org if you need additional information or
+ * have any questions.
+ */
+
+/**
+ * @file
+ *
+ * Streaming gzip (RFC 1952) decoder for
+ * com.sun.midp.io.j2me.http.GzipDecoder.
+ *
+ * The VM's Inflater reads a JAR entry from a file handle into heap
+ * objects, so it cannot be fed from a socket. This is a resumable
+ * inflater instead: every call decodes as much as the given input and
+ * output space allow, and suspends at the last complete symbol (or
+ * block header) when the input runs out. The
+ * whole state, including the 32 KB window, lives in a Java int array so
+ * nothing is allocated natively.
+ */
+
+#include <kni.h>
+#include <kni_globals.h>
+#include <sni.h>
+#include <string.h>
+
+#define WINDOW_SIZE 32768
+#define WINDOW_MASK (WINDOW_SIZE - 1)
+
+/* Codes of up to FAST_BITS bits are decoded with a single lookup */
+#define FAST_BITS 9
+
+#define MAX_BITS 15
+#define MAX_LCODES 286
+#define MAX_DCODES 30
+#define FIX_LCODES 288
+
+/* gzip header flags */
+#define GZ_FHCRC    0x02
+#define GZ_FEXTRA   0x04
+#define GZ_FNAME    0x08
+#define GZ_FCOMMENT 0x10
+#define GZ_RESERVED 0xe0
+
+/* Decoder modes */
+enum {
+    MODE_HEADER,      /* fixed part of the gzip header */
+    MODE_EXTRA_LEN,   /* FEXTRA length */
+    MODE_EXTRA,       /* FEXTRA data */
+    MODE_NAME,        /* zero terminated file name */
+    MODE_COMMENT,     /* zero terminated comment */
+    MODE_HCRC,        /* header CRC16 */
+    MODE_BLOCK,       /* deflate block header */
+    MODE_TABLES,      /* dynamic Huffman tables */
+    MODE_STORED_LEN,  /* LEN and NLEN of a stored block */
+    MODE_STORED,      /* data of a stored block */
+    MODE_CODES,       /* Huffman coded data */
+    MODE_COPY,        /* pending match copy */
+    MODE_TRAILER,     /* CRC32 and ISIZE */
+    MODE_DONE
+};
+
+typedef struct {
+    unsigned short count[MAX_BITS + 1];  /* codes of each length */
+    unsigned short symbol[FIX_LCODES];   /* symbols in canonical order */
+    unsigned short fast[1 << FAST_BITS]; /* (length << 9) | symbol, or 0 */
+} Huffman;
+
+/*
+ * The first two fields are read by GzipDecoder.java, keep them in sync
+ * with IN_USED and DONE there.
+ */
+typedef struct {
+    jint in_used;          /* input bytes consumed by the last call */
+    jint done;             /* non zero once the trailer was verified */
+
+    int mode;
+    unsigned int bitbuf;   /* bits not consumed yet, LSB first */
+    int bitcnt;
+
+    int flags;             /* gzip header flags */
+    int count;             /* bytes left in the current header field */
+    unsigned char trailer[8];
+
+    int last;              /* current block is the last one */
+    unsigned int length;   /* stored block or match length left */
+    unsigned int dist;     /* match distance */
+
+    unsigned int crc;      /* CRC32 of the output so far */
+    unsigned int isize;    /* output size mod 2^32 */
+    unsigned int wpos;     /* next write position in the window */
+    unsigned int whave;    /* valid bytes in the window */
+
+    Huffman lencode;
+    Huffman distcode;
+    unsigned char window[WINDOW_SIZE];
+} GzipState;
+
+static const unsigned short length_base[29] = {
+    3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31,
+    35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+};
+static const unsigned char length_extra[29] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2,
+    3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+};
+static const unsigned short dist_base[30] = {
+    1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193,
+    257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145,
+    8193, 12289, 16385, 24577
+};
+static const unsigned char dist_extra[30] = {
+    0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6,
+    7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+};
+static const unsigned char codelen_order[19] = {
+    16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15
+};
+
+static Huffman fixed_lencode;
+static Huffman fixed_distcode;
+static int fixed_built = 0;
+static unsigned int crc_table[256];
+
+/**
+ * Builds the canonical decoding tables for the given code lengths.
+ *
+ * @return 0 for a complete code, > 0 for an incomplete one and < 0 for
+ *         an over-subscribed one
+ */
+static int huffman_build(Huffman* h, const unsigned char* length, int n) {
+    unsigned short offs[MAX_BITS + 1];
+    unsigned short next[MAX_BITS + 1];
+    int left, len, sym, code;
+
+    memset(h->count, 0, sizeof(h->count));
+    memset(h->fast, 0, sizeof(h->fast));
+
+    for (sym = 0; sym < n; sym++) {
+        h->count[length[sym]]++;
+    }
+
+    if (h->count[0] == n) {
+        return 0;
+    }
+
+    left = 1;
+    for (len = 1; len <= MAX_BITS; len++) {
+        left <<= 1;
+        left -= h->count[len];
+        if (left < 0) {
+            return left;
+        }
+    }
+
+    offs[1] = 0;
+    for (len = 1; len < MAX_BITS; len++) {
+        offs[len + 1] = offs[len] + h->count[len];
+    }
+    code = 0;
+    next[1] = 0;
+    for (len = 2; len <= MAX_BITS; len++) {
+        code = (code + h->count[len - 1]) << 1;
+        next[len] = (unsigned short)code;
+    }
+
+    for (sym = 0; sym < n; sym++) {
+        len = length[sym];
+        if (len == 0) {
+            continue;
+        }
+
+        h->symbol[offs[len]++] = (unsigned short)sym;
+
+        if (len <= FAST_BITS) {
+            /* Codes are stored MSB first, the bit buffer is LSB first */
+            int c = next[len];
+            int rev = 0;
+            int i;
+
+            for (i = 0; i < len; i++) {
+                rev = (rev << 1) | ((c >> i) & 1);
+            }
+            for (i = rev; i < (1 << FAST_BITS); i += 1 << len) {
+                h->fast[i] = (unsigned short)((len << 9) | sym);
+            }
+        }
+        next[len]++;
+    }
+
+    return left;
+}
+
+static void build_static_tables(void) {
+    unsigned char lengths[FIX_LCODES];
+    unsigned int c;
+    int i, k;
+
+    for (i = 0; i < 144; i++) lengths[i] = 8;
+    for (; i < 256; i++) lengths[i] = 9;
+    for (; i < 280; i++) lengths[i] = 7;
+    for (; i < FIX_LCODES; i++) lengths[i] = 8;
+    huffman_build(&fixed_lencode, lengths, FIX_LCODES);
+
+    for (i = 0; i < MAX_DCODES; i++) lengths[i] = 5;
+    huffman_build(&fixed_distcode, lengths, MAX_DCODES);
+
+    for (i = 0; i < 256; i++) {
+        c = (unsigned int)i;
+        for (k = 0; k < 8; k++) {
+            c = (c & 1) ? (0xedb88320U ^ (c >> 1)) : (c >> 1);
+        }
+        crc_table[i] = c;
+    }
+
+    fixed_built = 1;
+}
+
+static unsigned int crc32_update(unsigned int crc, const unsigned char* p,
+                                 int len) {
+    crc = ~crc;
+    while (len-- > 0) {
+        crc = crc_table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+/**
+ * Decodes one symbol, the bit buffer must hold at least MAX_BITS bits
+ * or all the bits that are left.
+ *
+ * @return the symbol, -1 if more bits are needed or -2 for an invalid
+ *         code
+ */
+static int huffman_decode(const Huffman* h, unsigned int* bitbuf,
+                          int* bitcnt) {
+    unsigned int bits = *bitbuf;
+    int entry = h->fast[bits & ((1 << FAST_BITS) - 1)];
+    int code, first, index, len, count;
+
+    if (entry != 0) {
+        len = entry >> 9;
+        if (len > *bitcnt) {
+            return -1;
+        }
+        *bitbuf >>= len;
+        *bitcnt -= len;
+        return entry & 0x1ff;
+    }
+
+    code = first = index = 0;
+    for (len = 1; len <= MAX_BITS; len++) {
+        if (len > *bitcnt) {
+            return -1;
+        }
+        code |= (bits >> (len - 1)) & 1;
+        count = h->count[len];
+        if (code - count < first) {
+            *bitbuf >>= len;
+            *bitcnt -= len;
+            return h->symbol[index + (code - first)];
+        }
+        index += count;
+        first += count;
+        first <<= 1;
+        code <<= 1;
+    }
+
+    return -2;
+}
+
+/* Returned by gzip_inflate() for a corrupt stream */
+#define STATUS_ERROR  -1
+
+/*
+ * The bit buffer holds 32 bits, so at most 25 bits are requested at once.
+ * NEEDBITS suspends at the last save point when the input runs out.
+ */
+#define NEEDBITS(n) \
+    while (bitcnt < (n)) { \
+        if (in_pos >= in_len) goto suspend; \
+        bitbuf |= (unsigned int)in[in_pos++] << bitcnt; \
+        bitcnt += 8; \
+    }
+
+#define BITS(n) (bitbuf & ((1U << (n)) - 1))
+
+#define DROPBITS(n) { bitbuf >>= (n); bitcnt -= (n); }
+
+#define SAVE() { save_pos = in_pos; save_buf = bitbuf; save_cnt = bitcnt; }
+
+/* Fills the bit buffer as far as possible for a Huffman decode */
+#define PULLBITS() \
+    while (bitcnt <= 24 && in_pos < in_len) { \
+        bitbuf |= (unsigned int)in[in_pos++] << bitcnt; \
+        bitcnt += 8; \
+    }
+
+#define DECODE(h, sym) { \
+        PULLBITS(); \
+        sym = huffman_decode((h), &bitbuf, &bitcnt); \
+        if (sym == -1) goto suspend; \
+        if (sym < 0) goto error; \
+    }
+
+#define PUTBYTE(c) { \
+        unsigned char b_ = (unsigned char)(c); \
+        out[out_pos++] = b_; \
+        s->window[s->wpos++ & WINDOW_MASK] = b_; \
+    }
+
+/* Takes the next whole byte, from the bit buffer first */
+#define NEXTBYTE(b) { \
+        if (bitcnt >= 8) { \
+            b = bitbuf & 0xff; \
+            DROPBITS(8); \
+        } else if (in_pos < in_len) { \
+            b = in[in_pos++]; \
+        } else { \
+            goto suspend; \
+        } \
+    }
+
+/**
+ * Decodes from in[0..in_len) into out[0..out_len).
+ *
+ * @return number of bytes written to out, or STATUS_ERROR for a corrupt
+ *         stream. The number of input bytes consumed is left in
+ *         s->in_used.
+ */
+static int gzip_inflate(GzipState* s, const unsigned char* in, int in_len,
+                        unsigned char* out, int out_len) {
+    int in_pos = 0, out_pos = 0;
+    unsigned int bitbuf = s->bitbuf;
+    int bitcnt = s->bitcnt;
+    int save_pos;
+    unsigned int save_buf;
+    int save_cnt;
+    int produced = 0;
+    unsigned int b;
+
+    SAVE();
+
+    for (;;) {
+        switch (s->mode) {
+        case MODE_HEADER:
+            /* ID1 ID2 CM FLG MTIME(4) XFL OS */
+            while (s->count > 0) {
+                NEXTBYTE(b);
+                switch (10 - s->count) {
+                case 0:
+                    if (b != 0x1f) goto error;
+                    break;
+                case 1:
+                    if (b != 0x8b) goto error;
+                    break;
+                case 2:
+                    if (b != 8) goto error;
+                    break;
+                case 3:
+                    if (b & GZ_RESERVED) goto error;
+                    s->flags = b;
+                    break;
+                }
+                s->count--;
+                SAVE();
+            }
+            s->count = 2;
+            s->mode = MODE_EXTRA_LEN;
+            break;
+
+        case MODE_EXTRA_LEN:
+            if (!(s->flags & GZ_FEXTRA)) {
+                s->mode = MODE_NAME;
+                break;
+            }
+            while (s->count > 0) {
+                NEXTBYTE(b);
+                s->length = (s->count == 2) ? b : s->length | (b << 8);
+                s->count--;
+                SAVE();
+            }
+            s->mode = MODE_EXTRA;
+            break;
+
+        case MODE_EXTRA:
+            while (s->length > 0) {
+                NEXTBYTE(b);
+                s->length--;
+                SAVE();
+            }
+            s->mode = MODE_NAME;
+            break;
+
+        case MODE_NAME:
+        case MODE_COMMENT:
+            if (s->flags & (s->mode == MODE_NAME ? GZ_FNAME : GZ_FCOMMENT)) {
+                do {
+                    NEXTBYTE(b);
+                    SAVE();
+                } while (b != 0);
+            }
+            if (s->mode == MODE_NAME) {
+                s->mode = MODE_COMMENT;
+            } else {
+                s->count = 2;
+                s->mode = MODE_HCRC;
+            }
+            break;
+
+        case MODE_HCRC:
+            if (s->flags & GZ_FHCRC) {
+                while (s->count > 0) {
+                    NEXTBYTE(b);
+                    s->count--;
+                    SAVE();
+                }
+            }
+            s->mode = MODE_BLOCK;
+            break;
+
+        case MODE_BLOCK:
+            if (s->last) {
+                /* the trailer starts at the next byte boundary */
+                DROPBITS(bitcnt & 7);
+                s->count = 8;
+                s->mode = MODE_TRAILER;
+                SAVE();
+                break;
+            }
+            NEEDBITS(3);
+            s->last = BITS(1);
+            DROPBITS(1);
+            switch (BITS(2)) {
+            case 0:
+                DROPBITS(2);
+                DROPBITS(bitcnt & 7);
+                s->count = 4;
+                s->length = 0;
+                s->mode = MODE_STORED_LEN;
+                break;
+            case 1:
+                DROPBITS(2);
+                s->lencode = fixed_lencode;
+                s->distcode = fixed_distcode;
+                s->mode = MODE_CODES;
+                break;
+            case 2:
+                DROPBITS(2);
+                s->mode = MODE_TABLES;
+                break;
+            default:
+                goto error;
+            }
+            SAVE();
+            break;
+
+        case MODE_TABLES: {
+            /*
+             * The table definition is decoded in one go and resumed from
+             * its start; it is a few hundred bytes at most.
+             */
+            unsigned char lengths[MAX_LCODES + MAX_DCODES];
+            int nlen, ndist, ncode, index, sym, len, rep;
+
+            NEEDBITS(14);
+            nlen = BITS(5) + 257;
+            DROPBITS(5);
+            ndist = BITS(5) + 1;
+            DROPBITS(5);
+            ncode = BITS(4) + 4;
+            DROPBITS(4);
+            if (nlen > MAX_LCODES || ndist > MAX_DCODES) {
+                goto error;
+            }
+
+            for (index = 0; index < ncode; index++) {
+                NEEDBITS(3);
+                lengths[codelen_order[index]] = (unsigned char)BITS(3);
+                DROPBITS(3);
+            }
+            for (; index < 19; index++) {
+                lengths[codelen_order[index]] = 0;
+            }
+            if (huffman_build(&s->lencode, lengths, 19) != 0) {
+                goto error;
+            }
+
+            index = 0;
+            while (index < nlen + ndist) {
+                DECODE(&s->lencode, sym);
+                if (sym < 16) {
+                    lengths[index++] = (unsigned char)sym;
+                    continue;
+                }
+
+                len = 0;
+                if (sym == 16) {
+                    if (index == 0) {
+                        goto error;
+                    }
+                    len = lengths[index - 1];
+                    NEEDBITS(2);
+                    rep = 3 + BITS(2);
+                    DROPBITS(2);
+                } else if (sym == 17) {
+                    NEEDBITS(3);
+                    rep = 3 + BITS(3);
+                    DROPBITS(3);
+                } else {
+                    NEEDBITS(7);
+                    rep = 11 + BITS(7);
+                    DROPBITS(7);
+                }
+                if (index + rep > nlen + ndist) {
+                    goto error;
+                }
+                while (rep-- > 0) {
+                    lengths[index++] = (unsigned char)len;
+                }
+            }
+
+            if (lengths[256] == 0) {
+                goto error;
+            }
+
+            /* incomplete codes are only allowed for a single length */
+            rep = huffman_build(&s->lencode, lengths, nlen);
+            if (rep < 0 || (rep > 0 && nlen - s->lencode.count[0] != 1)) {
+                goto error;
+            }
+            rep = huffman_build(&s->distcode, lengths + nlen, ndist);
+            if (rep < 0 || (rep > 0 && ndist - s->distcode.count[0] != 1)) {
+                goto error;
+            }
+
+            s->mode = MODE_CODES;
+            SAVE();
+            break;
+        }
+
+        case MODE_STORED_LEN:
+            while (s->count > 0) {
+                NEXTBYTE(b);
+                s->length |= b << (8 * (4 - s->count));
+                s->count--;
+                SAVE();
+            }
+            if ((s->length & 0xffff) != (~s->length >> 16 & 0xffff)) {
+                goto error;
+            }
+            s->length &= 0xffff;
+            s->mode = MODE_STORED;
+            break;
+
+        case MODE_STORED:
+            while (s->length > 0 && bitcnt >= 8) {
+                if (out_pos == out_len) {
+                    goto suspend;
+                }
+                PUTBYTE(bitbuf & 0xff);
+                DROPBITS(8);
+                s->length--;
+                SAVE();
+            }
+            while (s->length > 0) {
+                int n = (int)s->length;
+                int i;
+
+                if (n > in_len - in_pos) {
+                    n = in_len - in_pos;
+                }
+                if (n > out_len - out_pos) {
+                    n = out_len - out_pos;
+                }
+                if (n == 0) {
+                    goto suspend;
+                }
+                for (i = 0; i < n; i++) {
+                    PUTBYTE(in[in_pos + i]);
+                }
+                in_pos += n;
+                s->length -= n;
+                SAVE();
+            }
+            s->mode = MODE_BLOCK;
+            break;
+
+        case MODE_CODES:
+            for (;;) {
+                int sym;
+
+                if (out_pos == out_len) {
+                    goto suspend;
+                }
+
+                DECODE(&s->lencode, sym);
+                if (sym < 256) {
+                    PUTBYTE(sym);
+                    SAVE();
+                    continue;
+                }
+
+                if (sym == 256) {
+                    s->mode = MODE_BLOCK;
+                    SAVE();
+                    break;
+                }
+
+                sym -= 257;
+                if (sym >= 29) {
+                    goto error;
+                }
+                NEEDBITS(length_extra[sym]);
+                s->length = length_base[sym] + BITS(length_extra[sym]);
+                DROPBITS(length_extra[sym]);
+
+                DECODE(&s->distcode, sym);
+                if (sym >= 30) {
+                    goto error;
+                }
+                NEEDBITS(dist_extra[sym]);
+                s->dist = dist_base[sym] + BITS(dist_extra[sym]);
+                DROPBITS(dist_extra[sym]);
+
+                if (s->dist > s->whave + out_pos) {
+                    goto error;
+                }
+
+                s->mode = MODE_COPY;
+                SAVE();
+                break;
+            }
+            break;
+
+        case MODE_COPY:
+            while (s->length > 0) {
+                if (out_pos == out_len) {
+                    goto suspend;
+                }
+                PUTBYTE(s->window[(s->wpos - s->dist) & WINDOW_MASK]);
+                s->length--;
+            }
+            SAVE();
+            s->mode = MODE_CODES;
+            break;
+
+        case MODE_TRAILER:
+            while (s->count > 0) {
+                NEXTBYTE(b);
+                s->trailer[8 - s->count] = (unsigned char)b;
+                s->count--;
+                SAVE();
+            }
+            /* Account for the output of this call before checking */
+            s->crc = crc32_update(s->crc, out, out_pos);
+            s->isize += out_pos;
+            out += out_pos;
+            out_len -= out_pos;
+            produced = out_pos;
+            out_pos = 0;
+            if (s->crc != ((unsigned int)s->trailer[0] |
+                           ((unsigned int)s->trailer[1] << 8) |
+                           ((unsigned int)s->trailer[2] << 16) |
+                           ((unsigned int)s->trailer[3] << 24)) ||
+                s->isize != ((unsigned int)s->trailer[4] |
+                             ((unsigned int)s->trailer[5] << 8) |
+                             ((unsigned int)s->trailer[6] << 16) |
+                             ((unsigned int)s->trailer[7] << 24))) {
+                goto error;
+            }
+            s->done = 1;
+            s->mode = MODE_DONE;
+            break;
+
+        case MODE_DONE:
+        default:
+            goto suspend;
+        }
+    }
+
+ suspend:
+    in_pos = save_pos;
+    bitbuf = save_buf;
+    bitcnt = save_cnt;
+
+    s->crc = crc32_update(s->crc, out, out_pos);
+    s->isize += out_pos;
+    s->whave += out_pos;
+    if (s->whave > WINDOW_SIZE) {
+        s->whave = WINDOW_SIZE;
+    }
+    s->bitbuf = bitbuf;
+    s->bitcnt = bitcnt;
+    s->in_used = in_pos;
+    return produced + out_pos;
+
+ error:
+    s->in_used = 0;
+    return STATUS_ERROR;
+}
+
+/*=========================================================================
+ * FUNCTION:      stateSize()I (STATIC)
+ * CLASS:         com/sun/midp/io/j2me/http/GzipDecoder
+ * TYPE:          static native function
+ * OVERVIEW:      Get the size of the decoder state.
+ * INTERFACE (operand stack manipulation):
+ *   parameters:  none
+ *   returns: size of the state in bytes
+ *=======================================================================*/
+KNIEXPORT KNI_RETURNTYPE_INT
+Java_com_sun_midp_io_j2me_http_GzipDecoder_stateSize() {
+    KNI_ReturnInt((jint)sizeof(GzipState));
+}
+
+/*=========================================================================
+ * FUNCTION:      init([I)V (STATIC)
+ * CLASS:         com/sun/midp/io/j2me/http/GzipDecoder
+ * TYPE:          static native function
+ * OVERVIEW:      Reset the decoder state to the start of a gzip stream.
+ * INTERFACE (operand stack manipulation):
+ *   parameters:  state      int array of at least stateSize() bytes
+ *   returns: nothing
+ *=======================================================================*/
+KNIEXPORT KNI_RETURNTYPE_VOID
+Java_com_sun_midp_io_j2me_http_GzipDecoder_init() {
+    GzipState* s;
+
+    KNI_StartHandles(1);
+    KNI_DeclareHandle(istate);
+
+    KNI_GetParameterAsObject(1, istate);
+
+    if (!fixed_built) {
+        build_static_tables();
+    }
+
+    /* int arrays are word aligned; no GC can happen below */
+    s = (GzipState*)SNI_GetRawArrayPointer(istate);
+    memset(s, 0, sizeof(GzipState) - WINDOW_SIZE);
+    s->mode = MODE_HEADER;
+    s->count = 10;
+
+    KNI_EndHandles();
+    KNI_ReturnVoid();
+}
+
+/*=========================================================================
+ * FUNCTION:      inflate([I[BII[BII)I (STATIC)
+ * CLASS:         com/sun/midp/io/j2me/http/GzipDecoder
+ * TYPE:          static native function
+ * OVERVIEW:      Decode as much of the input as fits into the output.
+ * INTERFACE (operand stack manipulation):
+ *   parameters:  state      decoder state, in_used and done are updated
+ *                in         compressed data
+ *                inOff      offset of the compressed data
+ *                inLen      number of compressed bytes
+ *                out        buffer for the decoded data
+ *                outOff     offset in the buffer
+ *                outLen     space in the buffer
+ *   returns: number of bytes decoded, throws IOException if the stream
+ *            is corrupt
+ *=======================================================================*/
+KNIEXPORT KNI_RETURNTYPE_INT
+Java_com_sun_midp_io_j2me_http_GzipDecoder_inflate() {
+    jint inOff = KNI_GetParameterAsInt(3);
+    jint inLen = KNI_GetParameterAsInt(4);
+    jint outOff = KNI_GetParameterAsInt(6);
+    jint outLen = KNI_GetParameterAsInt(7);
+    GzipState* s;
+    unsigned char *in, *out;
+    int n;
+
+    KNI_StartHandles(3);
+    KNI_DeclareHandle(istate);
+    KNI_DeclareHandle(iin);
+    KNI_DeclareHandle(iout);
+
+    KNI_GetParameterAsObject(1, istate);
+    KNI_GetParameterAsObject(2, iin);
+    KNI_GetParameterAsObject(5, iout);
+
+    /*
+     * Bounds were checked at Java level. Nothing below can trigger a GC,
+     * so the data is decoded in place.
+     */
+    s = (GzipState*)SNI_GetRawArrayPointer(istate);
+    in = (unsigned char*)SNI_GetRawArrayPointer(iin) + inOff;
+    out = (unsigned char*)SNI_GetRawArrayPointer(iout) + outOff;
+
+    n = gzip_inflate(s, in, inLen, out, outLen);
+    if (n < 0) {
+        n = 0;
+        KNI_ThrowNew(KNIIOException, "corrupt gzip data");
+    }
+
+    KNI_EndHandles();
+    KNI_ReturnInt(n);
+}
@@ -56,6 +56,9 @@ public class Protocol implements ConnectionBaseInterface, SocketConnection {
     /** Output stream open flag */
     protected boolean osopen = false;
 
+    /** Size of the buffer used by transferFrom() to copy a stream */
+    private static final int TRANSFER_BUFFER_SIZE = 4096;
+
 	private int m_port;
 	private String m_host;
 
@@ -157,6 +160,20 @@ public class Protocol implements ConnectionBaseInterface, SocketConnection {
         }
     }
 
+    /**
+     * Ensure connection is open for writing
+     */
+    void ensureWritable() throws IOException {
+        ensureOpen();
+        if ((mode&Connector.WRITE) == 0) {
+            throw new IOException(
+/* #ifdef VERBOSE_EXCEPTIONS */
+/// skipped                       "Connection not open for writing"
+/* #endif */
+            );
+        }
+    }
+
     /**
      * Returns an input stream for this socket.
      *
@@ -364,6 +381,106 @@ public class Protocol implements ConnectionBaseInterface, SocketConnection {
 		return -1;
 	}
 
+    /**
+     * Writes several array slices to the socket in one native call. Slice
+     * <code>i</code> is <code>lens[i]</code> bytes of <code>bufs[i]</code>
+     * starting at <code>offs[i]</code>. The method returns when all the
+     * slices have been written.
+     *
+     * @param bufs the arrays holding the data
+     * @param offs the start offset of each slice
+     * @param lens the number of bytes in each slice
+     * @exception IllegalArgumentException if the three arrays do not have
+     *            the same length
+     * @exception IndexOutOfBoundsException if a slice is outside its array
+     * @exception IOException if the connection is not open for writing or
+     *            an I/O error occurs
+     */
+    public void write(byte[][] bufs, int[] offs, int[] lens)
+            throws IOException {
+        ensureWritable();
+        int n = bufs.length;
+        if (offs.length != n || lens.length != n) {
+            throw new IllegalArgumentException();
+        }
+
+        // The native code advances private copies of the slices as it
+        // writes, and needs them to stay valid while it waits for the socket
+        byte[][] b = new byte[n][];
+        int[] off = new int[n];
+        int[] len = new int[n];
+        for (int i = 0; i < n; i++) {
+            b[i] = bufs[i];
+            off[i] = offs[i];
+            len[i] = lens[i];
+            if (off[i] < 0 || len[i] < 0 || len[i] > b[i].length - off[i]) {
+                throw new IndexOutOfBoundsException();
+            }
+        }
+        writeBufs(handle, b, off, len);
+    }
+
+    /**
+     * Sends up to <code>count</code> bytes read from <code>in</code> to the
+     * socket. If <code>in</code> reads a file the native layer can access
+     * (see {@link NativeFileSource}), such as a <code>FileConnection</code>
+     * input stream, the data is sent from the file without passing through
+     * the Java heap. Other streams, and files on platforms that cannot send
+     * them directly, are copied through a buffer.
+     *
+     * @param in the stream to read the data from
+     * @param count the maximum number of bytes to send
+     * @return the number of bytes sent, less than <code>count</code> only
+     *         if the end of the stream was reached
+     * @exception IllegalArgumentException if <code>count</code> is negative
+     * @exception IOException if the connection is not open for writing or
+     *            an I/O error occurs
+     */
+    public long transferFrom(InputStream in, long count) throws IOException {
+        ensureWritable();
+        if (count < 0) {
+            throw new IllegalArgumentException();
+        }
+
+        long done = 0;
+        if (in instanceof NativeFileSource) {
+            int file = ((NativeFileSource)in).getNativeReadHandle();
+            while (file != 0 && done < count) {
+                long left = count - done;
+                int n = transferFile(handle, file,
+                    left > Integer.MAX_VALUE ? Integer.MAX_VALUE : (int)left);
+                if (n == 0) {
+                    // End of the file
+                    return done;
+                }
+                if (n < 0) {
+                    // The platform cannot send files, copy the rest
+                    break;
+                }
+                done += n;
+            }
+        }
+
+        byte[] buf = null;
+        while (done < count) {
+            if (buf == null) {
+                buf = new byte[TRANSFER_BUFFER_SIZE];
+            }
+            long left = count - done;
+            int n = in.read(buf, 0,
+                left > buf.length ? buf.length : (int)left);
+            if (n < 0) {
+                break;
+            }
+            int off = 0;
+            while (off < n) {
+                off += writeBuf(handle, buf, off, n - off);
+            }
+            done += n;
+        }
+        return done;
+    }
+
    /*
     * A note about readByte()
     *
@@ -379,6 +496,9 @@ public class Protocol implements ConnectionBaseInterface, SocketConnection {
     protected static native int writeBuf(int handle, byte b[], int off,
                                           int len);
     protected static native int writeByte(int handle, int b);
+    protected static native void writeBufs(int handle, byte b[][], int off[],
+                                           int len[]);
+    protected static native int transferFile(int handle, int file, int len);
     protected static native int available0(int handle);
     protected static native void close0(int handle);
 }
@@ -398,6 +518,26 @@ class PrivateInputStream extends InputStream {
      */
     boolean eof = false;
 
+    /**
+     * Size of the read-ahead buffer used by single byte reads
+     */
+    private static final int READ_AHEAD_SIZE = 1024;
+
+    /**
+     * Read-ahead buffer, allocated by the first single byte read
+     */
+    private byte[] buf;
+
+    /**
+     * Position of the next byte to return from <code>buf</code>
+     */
+    private int pos;
+
+    /**
+     * Number of valid bytes in <code>buf</code>
+     */
+    private int count;
+
     /**
      * Constructor
      * @param pointer to the connection object
@@ -436,19 +576,29 @@ class PrivateInputStream extends InputStream {
      * @exception  IOException  if an I/O error occurs.
      */
     synchronized public int read() throws IOException {
-        int res;
         ensureOpen();
+        if (pos < count) {
+            return buf[pos++] & 0xff;
+        }
         if (eof) {
             return -1;
         }
-        res = Protocol.readByte(parent.handle);
-        if (res == -1) {
-            eof = true;
+        // Fill the read-ahead buffer with whatever the socket has, so that
+        // the following bytes do not need a native call each
+        if (buf == null) {
+            buf = new byte[READ_AHEAD_SIZE];
         }
+        int res = Protocol.readBuf(parent.handle, buf, 0, buf.length);
         if (parent == null) {
             throw new InterruptedIOException();
         }
-        return res;
+        if (res == -1) {
+            eof = true;
+            return -1;
+        }
+        pos = 1;
+        count = res;
+        return buf[0] & 0xff;
     }
 
     /**
@@ -482,16 +632,26 @@ class PrivateInputStream extends InputStream {
         // so that the native code doesn't need to do it
         int test = b[off] + b[off + len - 1];
 
+        if (pos < count) {
+            // Return buffered bytes first, without blocking for more
+            int n = count - pos;
+            if (n > len) {
+                n = len;
+            }
+            System.arraycopy(buf, pos, b, off, n);
+            pos += n;
+            return n;
+        }
 
-        int count = Protocol.readBuf(parent.handle, b, off, len);
-        if (count == -1) {
+        int res = Protocol.readBuf(parent.handle, b, off, len);
+        if (res == -1) {
             eof = true;
         }
 
         if (parent == null) {
             throw new InterruptedIOException();
         }
-        return count;
+        return res;
     }
 
     /**
@@ -504,7 +664,7 @@ class PrivateInputStream extends InputStream {
      */
     synchronized public int available() throws IOException {
         ensureOpen();
-        return Protocol.available0(parent.handle);
+        return (count - pos) + Protocol.available0(parent.handle);
     }
 
     /**
@@ -399,6 +399,82 @@ Java_com_sun_cldc_io_j2me_socket_Protocol_writeBuf() {
   KNI_ReturnInt(result);
 }
 
+/*
+ * Writes every slice of a gather list in one native call. The offsets and
+ * lengths are the caller's private copies; they are advanced as the data is
+ * written, so that after waiting for the socket the reinvocation resumes
+ * with the slice that blocked.
+ */
+KNIEXPORT KNI_RETURNTYPE_VOID
+Java_com_sun_cldc_io_j2me_socket_Protocol_writeBufs() {
+  void *handle = (void*)KNI_GetParameterAsInt(1);
+  SNIReentryData* info;
+  void *context = NULL;
+  int status = PCSL_NET_SUCCESS;
+  int nwrite;
+  int count;
+  int offset;
+  int length;
+  int i;
+
+  KNI_StartHandles(4);
+  {
+    KNI_DeclareHandle(bufs_object);
+    KNI_DeclareHandle(offs_object);
+    KNI_DeclareHandle(lens_object);
+    KNI_DeclareHandle(buffer_object);
+    KNI_GetParameterAsObject(2, bufs_object);
+    KNI_GetParameterAsObject(3, offs_object);
+    KNI_GetParameterAsObject(4, lens_object);
+
+    info = (SNIReentryData*)SNI_GetReentryData(NULL);
+    count = KNI_GetArrayLength(lens_object);
+
+    for (i = 0; i < count && status == PCSL_NET_SUCCESS; i++) {
+      length = KNI_GetIntArrayElement(lens_object, i);
+      while (length > 0) {
+        char *buffer;
+
+        offset = KNI_GetIntArrayElement(offs_object, i);
+        KNI_GetObjectArrayElement(bufs_object, i, buffer_object);
+        buffer = (char *) SNI_GetRawArrayPointer(buffer_object) + offset;
+
+        if (info == NULL) {
+          status = pcsl_socket_write_start(handle, buffer, length,
+                                           &nwrite, &context);
+        } else {
+          /* Only the slice that blocked is finished, later ones start anew */
+          context = info->pContext;
+          status = info->status;
+          info = NULL;
+          if (status == PCSL_NET_SUCCESS) {
+            status = pcsl_socket_write_finish(handle, buffer, length,
+                                              &nwrite, context);
+          }
+        }
+        if (status != PCSL_NET_SUCCESS) {
+          break;
+        }
+
+        offset += nwrite;
+        length -= nwrite;
+        KNI_SetIntArrayElement(offs_object, i, offset);
+        KNI_SetIntArrayElement(lens_object, i, length);
+      }
+    }
+
+    if (status == PCSL_NET_WOULDBLOCK) {
+      SNIEVT_wait(NETWORK_WRITE_SIGNAL, (int)handle, context);
+    } else if (status == PCSL_NET_INTERRUPTED) {
+      KNI_ThrowNew(KNIInterruptedIOException, "socket writing operation has been interrupted");
+    } else if (status != PCSL_NET_SUCCESS) {
+      KNI_ThrowNew(KNIIOException, "socket write error");
+    }
+  }
+  KNI_EndHandles();
+  KNI_ReturnVoid();
+}
+
 KNIEXPORT KNI_RETURNTYPE_INT
 Java_com_sun_cldc_io_j2me_socket_Protocol_writeByte() {
   void *handle = (void*)KNI_GetParameterAsInt(1);
@@ -414,10 +490,57 @@ Java_com_sun_cldc_io_j2me_socket_Protocol_writeByte() {
   return result;
 }
 
+/*
+ * Sends up to length bytes from a file opened by the FileConnection natives,
+ * starting at the file's current position. Returns the number of bytes
+ * sent, 0 at the end of the file, or -1 if the platform cannot send files
+ * directly, in which case nothing has been sent.
+ */
+KNIEXPORT KNI_RETURNTYPE_INT
+Java_com_sun_cldc_io_j2me_socket_Protocol_transferFile() {
+  void *handle = (void*)KNI_GetParameterAsInt(1);
+  void *file = (void*)KNI_GetParameterAsInt(2);
+  int length = KNI_GetParameterAsInt(3);
+  SNIReentryData* info;
+  void *context;
+  int nwrite = 0;
+  int status;
+
+  info = (SNIReentryData*)SNI_GetReentryData(NULL);
+  if (info == NULL) {	/* First invocation */
+    status = pcsl_socket_sendfile_start(handle, file, length,
+                                        &nwrite, &context);
+  } else {
+    context = info->pContext;
+    status = info->status;
+    if (status == PCSL_NET_SUCCESS) {
+      status = pcsl_socket_sendfile_finish(handle, file, length,
+                                           &nwrite, context);
+    }
+  }
+
+  if (status == PCSL_NET_WOULDBLOCK) {
+    SNIEVT_wait(NETWORK_WRITE_SIGNAL, (int)handle, context);
+  } else if (status == PCSL_NET_NOTSUPPORTED) {
+    nwrite = -1;
+  } else if (status == PCSL_NET_INTERRUPTED) {
+    KNI_ThrowNew(KNIInterruptedIOException, "socket writing operation has been interrupted");
+  } else if (status != PCSL_NET_SUCCESS) {
+    KNI_ThrowNew(KNIIOException, "socket write error");
+  }
+
+  KNI_ReturnInt(nwrite);
+}
+
 KNIEXPORT KNI_RETURNTYPE_INT
 Java_com_sun_cldc_io_j2me_socket_Protocol_available0() {
-  // unsupported. Not used by CLDC TCK
-  KNI_ReturnInt(0);
+  void *handle = (void*)KNI_GetParameterAsInt(1);
+  int bytesAvailable = 0;
+
+  if (pcsl_socket_available(handle, &bytesAvailable) != PCSL_NET_SUCCESS) {
+    bytesAvailable = 0;
+  }
+  KNI_ReturnInt(bytesAvailable);
 }
 
 KNIEXPORT KNI_RETURNTYPE_VOID
@@ -10,6 +10,8 @@ import org.bouncycastle.crypto.modes.CBCBlockCipher;
 public class DefaultTlsCipherFactory
     extends AbstractTlsCipherFactory
 {
+    private static final String NATIVE_AES_CBC = "com.sun.midp.crypto.NativeAESCBC";
+
     public TlsCipher createCipher(TlsContext context, int encryptionAlgorithm, int macAlgorithm)
         throws IOException
     {
@@ -47,7 +49,18 @@ public class DefaultTlsCipherFactory
 
     protected BlockCipher createAESBlockCipher()
     {
-        return new CBCBlockCipher(createAESEngine());
+        /*
+         * Prefer the native AES/CBC implementation, which encrypts a whole
+         * record per call. It is only present in builds with native crypto.
+         */
+        try
+        {
+            return (BlockCipher)Class.forName(NATIVE_AES_CBC).newInstance();
+        }
+        catch (Throwable t)
+        {
+            return new CBCBlockCipher(createAESEngine());
+        }
     }
 
     protected Digest createHMACDigest(int macAlgorithm) throws IOException
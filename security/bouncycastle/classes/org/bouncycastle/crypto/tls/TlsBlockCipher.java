@@ -5,6 +5,7 @@ import java.io.IOException;
 import org.bouncycastle.crypto.BlockCipher;
 import org.bouncycastle.crypto.CipherParameters;
 import org.bouncycastle.crypto.Digest;
+import org.bouncycastle.crypto.MultiBlockCipher;
 import org.bouncycastle.crypto.params.KeyParameter;
 import org.bouncycastle.crypto.params.ParametersWithIV;
 import org.bouncycastle.util.Arrays;
@@ -218,10 +219,7 @@ public class TlsBlockCipher
             outBuf[outOff++] = (byte)padding_length;
         }
 
-        for (int i = blocks_start; i < outOff; i += blockSize)
-        {
-            encryptCipher.processBlock(outBuf, i, outBuf, i);
-        }
+        processBlocks(encryptCipher, outBuf, blocks_start, outOff - blocks_start);
 
         if (encryptThenMAC)
         {
@@ -301,10 +299,7 @@ public class TlsBlockCipher
             blocks_length -= blockSize;
         }
 
-        for (int i = 0; i < blocks_length; i += blockSize)
-        {
-            decryptCipher.processBlock(ciphertext, offset + i, ciphertext, offset + i);
-        }
+        processBlocks(decryptCipher, ciphertext, offset, blocks_length);
 
         // If there's anything wrong with the padding, this will return zero
         int totalPad = checkPaddingConstantTime(ciphertext, offset, blocks_length, blockSize, encryptThenMAC ? 0 : macSize);
@@ -332,6 +327,26 @@ public class TlsBlockCipher
         return Arrays.copyOfRange(ciphertext, offset, offset + dec_output_length);
     }
 
+    /**
+     * Process len bytes of buf in place. A cipher that can handle several
+     * blocks at once gets the whole record in a single call.
+     */
+    protected void processBlocks(BlockCipher cipher, byte[] buf, int off, int len)
+    {
+        int blockSize = cipher.getBlockSize();
+
+        if (cipher instanceof MultiBlockCipher)
+        {
+            ((MultiBlockCipher)cipher).processBlocks(buf, off, len / blockSize, buf, off);
+            return;
+        }
+
+        for (int i = 0; i < len; i += blockSize)
+        {
+            cipher.processBlock(buf, off + i, buf, off + i);
+        }
+    }
+
     protected int checkPaddingConstantTime(byte[] buf, int off, int len, int blockSize, int macSize)
     {
         int end = off + len;
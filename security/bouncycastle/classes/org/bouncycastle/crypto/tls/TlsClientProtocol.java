@@ -135,7 +135,21 @@ public class TlsClientProtocol
     {
         if (this.resumedSession)
         {
-            if (type != HandshakeType.finished || this.connection_state != CS_SERVER_HELLO)
+            /*
+             * RFC 5077 3.1. A server resuming a session from a ticket may issue a fresh ticket
+             * before its ChangeCipherSpec. The resumed session itself stays valid.
+             */
+            if (type == HandshakeType.session_ticket && this.expectSessionTicket
+                && this.connection_state == CS_SERVER_HELLO)
+            {
+                receiveNewSessionTicketMessage(buf);
+                this.connection_state = CS_SERVER_SESSION_TICKET;
+                return;
+            }
+
+            if (type != HandshakeType.finished
+                || (this.connection_state != CS_SERVER_HELLO && this.connection_state != CS_SERVER_SESSION_TICKET)
+                || (this.connection_state == CS_SERVER_HELLO && this.expectSessionTicket))
             {
                 throw new TlsFatalAlert(AlertDescription.unexpected_message);
             }
@@ -798,6 +812,16 @@ public class TlsClientProtocol
                     AlertDescription.illegal_parameter);
         }
 
+        if (this.resumedSession)
+        {
+            /*
+             * The stored server extensions describe the original session; whether a new ticket
+             * follows is announced in this ServerHello.
+             */
+            this.expectSessionTicket = TlsUtils.hasExpectedEmptyExtensionData(this.serverExtensions,
+                TlsProtocol.EXT_SessionTicket, AlertDescription.illegal_parameter);
+        }
+
         /*
          * TODO[session-hash]
          * 
@@ -845,8 +869,9 @@ public class TlsClientProtocol
         getContextAdmin().setClientVersion(client_version);
 
         /*
-         * TODO RFC 5077 3.4. When presenting a ticket, the client MAY generate and include a
-         * Session ID in the TLS ClientHello.
+         * RFC 5077 3.4. When presenting a ticket, the client MAY generate and include a
+         * Session ID in the TLS ClientHello. Clients that present tickets do so by returning a
+         * session carrying such an ID from TlsClient.getSessionToResume().
          */
         byte[] session_id = TlsUtils.EMPTY_BYTES;
         if (this.tlsSession != null)
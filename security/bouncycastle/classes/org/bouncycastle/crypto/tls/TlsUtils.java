@@ -21,18 +21,17 @@ import org.bouncycastle.asn1.x509.SubjectPublicKeyInfo;
 import org.bouncycastle.asn1.x509.X509ObjectIdentifiers;
 import org.bouncycastle.crypto.Digest;
 import org.bouncycastle.crypto.digests.MD5Digest;
-import org.bouncycastle.crypto.digests.SHA1Digest;
 import org.bouncycastle.crypto.digests.SHA224Digest;
-import org.bouncycastle.crypto.digests.SHA256Digest;
 import org.bouncycastle.crypto.digests.SHA384Digest;
-import org.bouncycastle.crypto.digests.SHA512Digest;
 import org.bouncycastle.crypto.macs.HMac;
 import org.bouncycastle.crypto.params.AsymmetricKeyParameter;
 import org.bouncycastle.crypto.params.KeyParameter;
 import org.bouncycastle.crypto.params.RSAKeyParameters;
+import org.bouncycastle.crypto.util.DigestFactory;
 import org.bouncycastle.crypto.util.PublicKeyFactory;
 import org.bouncycastle.util.Arrays;
 import org.bouncycastle.util.Integers;
+import org.bouncycastle.util.Memoable;
 import org.bouncycastle.util.Shorts;
 import org.bouncycastle.util.Strings;
 import org.bouncycastle.util.io.Streams;
@@ -1169,15 +1168,15 @@ public class TlsUtils
         case HashAlgorithm.md5:
             return new MD5Digest();
         case HashAlgorithm.sha1:
-            return new SHA1Digest();
+            return DigestFactory.createSHA1();
 		case HashAlgorithm.sha224:            
 			return new SHA224Digest();
         case HashAlgorithm.sha256:
-            return new SHA256Digest();
+            return DigestFactory.createSHA256();
         case HashAlgorithm.sha384:
             return new SHA384Digest();
         case HashAlgorithm.sha512:
-            return new SHA512Digest();
+            return DigestFactory.createSHA512();
         default:
             throw new IllegalArgumentException("unknown HashAlgorithm: "+hashAlgorithm);
         }
@@ -1197,15 +1196,15 @@ public class TlsUtils
         case HashAlgorithm.md5:
             return new MD5Digest((MD5Digest)hash);
         case HashAlgorithm.sha1:
-            return new SHA1Digest((SHA1Digest)hash);
+            return (Digest)((Memoable)hash).copy();
 		case HashAlgorithm.sha224:            
 			return new SHA224Digest((SHA224Digest)hash);
         case HashAlgorithm.sha256:
-            return new SHA256Digest((SHA256Digest)hash);
+            return (Digest)((Memoable)hash).copy();
         case HashAlgorithm.sha384:
             return new SHA384Digest((SHA384Digest)hash);
         case HashAlgorithm.sha512:
-            return new SHA512Digest((SHA512Digest)hash);
+            return (Digest)((Memoable)hash).copy();
         default:
             throw new IllegalArgumentException("unknown HashAlgorithm");
         }
@@ -14,6 +14,41 @@ import org.bouncycastle.crypto.digests.SHA512tDigest;
  */
 public final class DigestFactory
 {
+    /*
+     * Native SHA implementations. They are only present in builds with
+     * native crypto, otherwise the Java digests are used.
+     */
+    private static final Class nativeSHA1 = findClass("com.sun.midp.crypto.NativeSHA1Digest");
+    private static final Class nativeSHA256 = findClass("com.sun.midp.crypto.NativeSHA256Digest");
+    private static final Class nativeSHA512 = findClass("com.sun.midp.crypto.NativeSHA512Digest");
+
+    private static Class findClass(String name)
+    {
+        try
+        {
+            return Class.forName(name);
+        }
+        catch (Throwable t)
+        {
+            return null;
+        }
+    }
+
+    private static Digest createNative(Class digestClass)
+    {
+        if (digestClass != null)
+        {
+            try
+            {
+                return (Digest)digestClass.newInstance();
+            }
+            catch (Throwable t)
+            {
+            }
+        }
+        return null;
+    }
+
     public static Digest createMD5()
     {
         return new MD5Digest();
@@ -21,7 +56,8 @@ public final class DigestFactory
 
     public static Digest createSHA1()
     {
-        return new SHA1Digest();
+        Digest d = createNative(nativeSHA1);
+        return d != null ? d : new SHA1Digest();
     }
 	
 	public static Digest createSHA224()    
@@ -31,7 +67,8 @@ public final class DigestFactory
 
     public static Digest createSHA256()
     {
-        return new SHA256Digest();
+        Digest d = createNative(nativeSHA256);
+        return d != null ? d : new SHA256Digest();
     }
 
     public static Digest createSHA384()
@@ -41,7 +78,8 @@ public final class DigestFactory
 
     public static Digest createSHA512()
     {
-        return new SHA512Digest();
+        Digest d = createNative(nativeSHA512);
+        return d != null ? d : new SHA512Digest();
     }
 
     public static Digest createSHA512_224()
@@ -21,21 +21,23 @@
 
 package com.sun.midp.crypto;
 
-import org.bouncycastle.crypto.digests.SHA1Digest;
+import org.bouncycastle.crypto.Digest;
+import org.bouncycastle.crypto.util.DigestFactory;
+import org.bouncycastle.util.Memoable;
 
 /**
  * Implements the SHA-1 message digest algorithm.
  */ 
 final class SHA extends MessageDigest {
 
-	private SHA1Digest impl;
+	private Digest impl;
 
     /** Create SHA digest object. */
     SHA() {
-        impl = new SHA1Digest();
+        impl = DigestFactory.createSHA1();
     }
 
-	SHA(SHA1Digest another_digest) {
+	SHA(Digest another_digest) {
 		impl = another_digest;
 	}
 
@@ -97,7 +99,7 @@ final class SHA extends MessageDigest {
      * @return a clone of this object
      */
     public Object clone() {
-		return new SHA(new SHA1Digest(impl));
+		return new SHA((Digest)((Memoable)impl).copy());
     }
 }
 
@@ -26,21 +26,23 @@
 
 package com.sun.midp.crypto;
 
-import org.bouncycastle.crypto.digests.SHA256Digest;
+import org.bouncycastle.crypto.Digest;
+import org.bouncycastle.crypto.util.DigestFactory;
+import org.bouncycastle.util.Memoable;
 
 /**
  * Implements the SHA-256 message digest algorithm.
  */ 
 final class SHA256 extends MessageDigest {
 
-	private SHA256Digest impl;
+	private Digest impl;
 
     /** Create SHA digest object. */
     SHA256() {
-        impl = new SHA256Digest();
+        impl = DigestFactory.createSHA256();
     }
 
-	SHA256(SHA256Digest another_digest) {
+	SHA256(Digest another_digest) {
 		impl = another_digest;
 	}
 
@@ -102,6 +104,6 @@ final class SHA256 extends MessageDigest {
      * @return a clone of this object
      */
     public Object clone() {
-		return new SHA256(new SHA256Digest(impl));
+		return new SHA256((Digest)((Memoable)impl).copy());
     }
 }
@@ -0,0 +1,468 @@
+/*
+ * Copyright (C) Max Mu
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * Please visit www.joshvm.org if you need additional information or
+ * have any questions.
+ */
+
+/**
+ * @file
+ *
+ * Native AES in CBC mode for com.sun.midp.crypto.NativeAESCBC.
+ *
+ * A whole buffer is processed per call. On x86 built with GCC the
+ * AES-NI instructions are used when the CPU has them. Otherwise a
+ * portable implementation runs in constant time: it has no tables at
+ * all, SubBytes is computed in GF(2^8) (see sub_word()) and MixColumns
+ * arithmetically, so neither the key nor the data select memory
+ * addresses or branches. The key expansion uses the same code on all
+ * platforms.
+ */
+
+#include <kni.h>
+#include <sni.h>
+#include <string.h>
+#include <stdint.h>
+
+#define AES_BLOCK_SIZE 16
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__)) && \
+    (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define AES_USE_AESNI 1
+#include <cpuid.h>
+#include <wmmintrin.h>
+#else
+#define AES_USE_AESNI 0
+#endif
+
+#define XTIME(x) ((unsigned char)(((x) << 1) ^ (-(((x) >> 7) & 1) & 0x1b)))
+
+/*
+ * SubBytes is computed rather than looked up: the multiplicative inverse
+ * in GF(2^8) is raised as x^254 and followed by the affine transform. The
+ * arithmetic runs on the four bytes of a 32 bit word at once and uses
+ * neither secret dependent indexes nor branches.
+ */
+
+#define LANES(b) ((uint32_t)(b) * 0x01010101U)
+
+/* Spreads a 0 or 1 in each byte to 0x00 or 0xff */
+static uint32_t lane_mask(uint32_t bits) {
+    return (bits << 8) - bits;
+}
+
+static uint32_t gf_xtime4(uint32_t a) {
+    return ((a & LANES(0x7f)) << 1) ^
+           (lane_mask((a >> 7) & LANES(0x01)) & LANES(0x1b));
+}
+
+static uint32_t gf_mul4(uint32_t a, uint32_t b) {
+    uint32_t r = 0;
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        r ^= a & lane_mask((b >> i) & LANES(0x01));
+        a = gf_xtime4(a);
+    }
+    return r;
+}
+
+/* Squaring is linear: bit i of each byte maps to x^(2i) */
+static uint32_t gf_square4(uint32_t a) {
+    static const unsigned char sq[8] = {
+        0x01, 0x04, 0x10, 0x40, 0x1b, 0x6c, 0xab, 0x9a
+    };
+    uint32_t r = 0;
+    int i;
+
+    for (i = 0; i < 8; i++) {
+        r ^= LANES(sq[i]) & lane_mask((a >> i) & LANES(0x01));
+    }
+    return r;
+}
+
+/* x^254, which is the inverse of x and maps 0 to 0 */
+static uint32_t gf_inv4(uint32_t x) {
+    uint32_t x2, x3, x12, x15, x240;
+
+    x2 = gf_square4(x);
+    x3 = gf_mul4(x2, x);
+    x12 = gf_square4(gf_square4(x3));
+    x15 = gf_mul4(x12, x3);
+    x240 = gf_square4(gf_square4(gf_square4(gf_square4(x15))));
+    return gf_mul4(x240, gf_mul4(x12, x2));
+}
+
+/* Rotates each byte left by k bits */
+#define ROTL4(b, k) ((((b) << (k)) & LANES((0xff << (k)) & 0xff)) | \
+                     (((b) >> (8 - (k))) & LANES(0xff >> (8 - (k)))))
+
+static uint32_t sub_word(uint32_t x) {
+    uint32_t b = gf_inv4(x);
+    return b ^ ROTL4(b, 1) ^ ROTL4(b, 2) ^ ROTL4(b, 3) ^ ROTL4(b, 4) ^
+           LANES(0x63);
+}
+
+static uint32_t inv_sub_word(uint32_t y) {
+    return gf_inv4(ROTL4(y, 1) ^ ROTL4(y, 3) ^ ROTL4(y, 6) ^ LANES(0x05));
+}
+
+static void sub_bytes(unsigned char* s) {
+    uint32_t x;
+    int i;
+
+    for (i = 0; i < AES_BLOCK_SIZE; i += 4) {
+        memcpy(&x, s + i, 4);
+        x = sub_word(x);
+        memcpy(s + i, &x, 4);
+    }
+}
+
+static void inv_sub_bytes(unsigned char* s) {
+    uint32_t x;
+    int i;
+
+    for (i = 0; i < AES_BLOCK_SIZE; i += 4) {
+        memcpy(&x, s + i, 4);
+        x = inv_sub_word(x);
+        memcpy(s + i, &x, 4);
+    }
+}
+
+/**
+ * Expands a 16, 24 or 32 byte key into the AES round keys.
+ *
+ * @return the number of rounds
+ */
+static int aes_expand_key(const unsigned char* key, int keyLen,
+                          unsigned char* w) {
+    int nk = keyLen / 4;
+    int nr = nk + 6;
+    int total = 4 * (nr + 1);
+    unsigned char rcon = 1;
+    unsigned char t[4];
+    uint32_t x;
+    int i;
+
+    memcpy(w, key, keyLen);
+
+    for (i = nk; i < total; i++) {
+        if (i % nk == 0) {
+            /* RotWord */
+            t[0] = w[4 * i - 3];
+            t[1] = w[4 * i - 2];
+            t[2] = w[4 * i - 1];
+            t[3] = w[4 * i - 4];
+        } else {
+            memcpy(t, w + 4 * (i - 1), 4);
+        }
+
+        if (i % nk == 0 || (nk > 6 && i % nk == 4)) {
+            memcpy(&x, t, 4);
+            x = sub_word(x);
+            memcpy(t, &x, 4);
+        }
+        if (i % nk == 0) {
+            t[0] ^= rcon;
+            rcon = XTIME(rcon);
+        }
+
+        w[4 * i]     = w[4 * (i - nk)]     ^ t[0];
+        w[4 * i + 1] = w[4 * (i - nk) + 1] ^ t[1];
+        w[4 * i + 2] = w[4 * (i - nk) + 2] ^ t[2];
+        w[4 * i + 3] = w[4 * (i - nk) + 3] ^ t[3];
+    }
+
+    return nr;
+}
+
+static void add_round_key(unsigned char* s, const unsigned char* k) {
+    int i;
+    for (i = 0; i < AES_BLOCK_SIZE; i++) {
+        s[i] ^= k[i];
+    }
+}
+
+/* SubBytes and ShiftRows; the state is column major */
+static void sub_shift(unsigned char* s) {
+    unsigned char t;
+
+    sub_bytes(s);
+
+    t = s[1];
+    s[1] = s[5]; s[5] = s[9]; s[9] = s[13]; s[13] = t;
+
+    t = s[2];
+    s[2] = s[10]; s[10] = t;
+    t = s[6];
+    s[6] = s[14]; s[14] = t;
+
+    t = s[15];
+    s[15] = s[11]; s[11] = s[7]; s[7] = s[3]; s[3] = t;
+}
+
+static void inv_sub_shift(unsigned char* s) {
+    unsigned char t;
+
+    inv_sub_bytes(s);
+
+    t = s[13];
+    s[13] = s[9]; s[9] = s[5]; s[5] = s[1]; s[1] = t;
+
+    t = s[2];
+    s[2] = s[10]; s[10] = t;
+    t = s[6];
+    s[6] = s[14]; s[14] = t;
+
+    t = s[3];
+    s[3] = s[7]; s[7] = s[11]; s[11] = s[15]; s[15] = t;
+}
+
+static void mix_columns(unsigned char* s) {
+    unsigned char a0, a1, a2, a3, all;
+    int c;
+
+    for (c = 0; c < AES_BLOCK_SIZE; c += 4) {
+        a0 = s[c]; a1 = s[c + 1]; a2 = s[c + 2]; a3 = s[c + 3];
+        all = a0 ^ a1 ^ a2 ^ a3;
+        s[c]     = a0 ^ all ^ XTIME(a0 ^ a1);
+        s[c + 1] = a1 ^ all ^ XTIME(a1 ^ a2);
+        s[c + 2] = a2 ^ all ^ XTIME(a2 ^ a3);
+        s[c + 3] = a3 ^ all ^ XTIME(a3 ^ a0);
+    }
+}
+
+static void inv_mix_columns(unsigned char* s) {
+    unsigned char u, v;
+    int c;
+
+    /* Reduce InvMixColumns to MixColumns with a cheap pre-pass */
+    for (c = 0; c < AES_BLOCK_SIZE; c += 4) {
+        u = XTIME(XTIME(s[c] ^ s[c + 2]));
+        v = XTIME(XTIME(s[c + 1] ^ s[c + 3]));
+        s[c]     ^= u;
+        s[c + 1] ^= v;
+        s[c + 2] ^= u;
+        s[c + 3] ^= v;
+    }
+
+    mix_columns(s);
+}
+
+static void aes_encrypt_block(const unsigned char* w, int nr,
+                              unsigned char* s) {
+    int r;
+
+    add_round_key(s, w);
+    for (r = 1; r < nr; r++) {
+        sub_shift(s);
+        mix_columns(s);
+        add_round_key(s, w + AES_BLOCK_SIZE * r);
+    }
+    sub_shift(s);
+    add_round_key(s, w + AES_BLOCK_SIZE * nr);
+}
+
+static void aes_decrypt_block(const unsigned char* w, int nr,
+                              unsigned char* s) {
+    int r;
+
+    add_round_key(s, w + AES_BLOCK_SIZE * nr);
+    for (r = nr - 1; r > 0; r--) {
+        inv_sub_shift(s);
+        add_round_key(s, w + AES_BLOCK_SIZE * r);
+        inv_mix_columns(s);
+    }
+    inv_sub_shift(s);
+    add_round_key(s, w);
+}
+
+static void aes_cbc(const unsigned char* w, int nr, int encrypt,
+                    unsigned char* iv, const unsigned char* in,
+                    unsigned char* out, int len) {
+    unsigned char s[AES_BLOCK_SIZE];
+    unsigned char c[AES_BLOCK_SIZE];
+    int i, off;
+
+    for (off = 0; off < len; off += AES_BLOCK_SIZE) {
+        if (encrypt) {
+            for (i = 0; i < AES_BLOCK_SIZE; i++) {
+                s[i] = in[off + i] ^ iv[i];
+            }
+            aes_encrypt_block(w, nr, s);
+            memcpy(iv, s, AES_BLOCK_SIZE);
+        } else {
+            /* in and out may overlap, so keep the ciphertext first */
+            memcpy(c, in + off, AES_BLOCK_SIZE);
+            memcpy(s, c, AES_BLOCK_SIZE);
+            aes_decrypt_block(w, nr, s);
+            for (i = 0; i < AES_BLOCK_SIZE; i++) {
+                s[i] ^= iv[i];
+            }
+            memcpy(iv, c, AES_BLOCK_SIZE);
+        }
+        memcpy(out + off, s, AES_BLOCK_SIZE);
+    }
+}
+
+#if AES_USE_AESNI
+
+static int aesni_available(void) {
+    static int available = -1;
+    unsigned int a, b, c, d;
+
+    if (available < 0) {
+        available = __get_cpuid(1, &a, &b, &c, &d) && (c & bit_AES) != 0;
+    }
+    return available;
+}
+
+__attribute__((target("aes,sse2")))
+static void aesni_cbc(const unsigned char* w, int nr, int encrypt,
+                      unsigned char* iv, const unsigned char* in,
+                      unsigned char* out, int len) {
+    __m128i k[15];
+    __m128i v, x, c;
+    int i, off;
+
+    for (i = 0; i <= nr; i++) {
+        k[i] = _mm_loadu_si128((const __m128i*)(w + AES_BLOCK_SIZE * i));
+    }
+    v = _mm_loadu_si128((const __m128i*)iv);
+
+    if (encrypt) {
+        for (off = 0; off < len; off += AES_BLOCK_SIZE) {
+            x = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(in + off)), v);
+            x = _mm_xor_si128(x, k[0]);
+            for (i = 1; i < nr; i++) {
+                x = _mm_aesenc_si128(x, k[i]);
+            }
+            v = _mm_aesenclast_si128(x, k[nr]);
+            _mm_storeu_si128((__m128i*)(out + off), v);
+        }
+    } else {
+        /* The equivalent inverse cipher needs InvMixColumns'd keys */
+        for (i = 1; i < nr; i++) {
+            k[i] = _mm_aesimc_si128(k[i]);
+        }
+        for (off = 0; off < len; off += AES_BLOCK_SIZE) {
+            c = _mm_loadu_si128((const __m128i*)(in + off));
+            x = _mm_xor_si128(c, k[nr]);
+            for (i = nr - 1; i > 0; i--) {
+                x = _mm_aesdec_si128(x, k[i]);
+            }
+            x = _mm_aesdeclast_si128(x, k[0]);
+            _mm_storeu_si128((__m128i*)(out + off), _mm_xor_si128(x, v));
+            v = c;
+        }
+    }
+
+    _mm_storeu_si128((__m128i*)iv, v);
+}
+
+#endif
+
+/*=========================================================================
+ * FUNCTION:      expandKey([B[B)I (STATIC)
+ * CLASS:         com/sun/midp/crypto/NativeAESCBC
+ * TYPE:          static native function
+ * OVERVIEW:      Expand an AES key into its round keys.
+ * INTERFACE (operand stack manipulation):
+ *   parameters:  key       the 16, 24 or 32 byte key
+ *                schedule  receives the round keys, at least 240 bytes
+ *   returns: the number of rounds
+ *=======================================================================*/
+KNIEXPORT KNI_RETURNTYPE_INT
+Java_com_sun_midp_crypto_NativeAESCBC_expandKey() {
+    jint rounds;
+    jint keyLen;
+
+    KNI_StartHandles(2);
+    KNI_DeclareHandle(ikey);
+    KNI_DeclareHandle(ischedule);
+
+    KNI_GetParameterAsObject(1, ikey);
+    KNI_GetParameterAsObject(2, ischedule);
+
+    /* Key length was checked at Java level */
+    keyLen = KNI_GetArrayLength(ikey);
+    rounds = aes_expand_key((unsigned char*)SNI_GetRawArrayPointer(ikey),
+                            keyLen,
+                            (unsigned char*)SNI_GetRawArrayPointer(ischedule));
+
+    KNI_EndHandles();
+    KNI_ReturnInt(rounds);
+}
+
+/*=========================================================================
+ * FUNCTION:      cbc([BIZ[B[BII[BI)V (STATIC)
+ * CLASS:         com/sun/midp/crypto/NativeAESCBC
+ * TYPE:          static native function
+ * OVERVIEW:      Encrypt or decrypt whole blocks in CBC mode.
+ * INTERFACE (operand stack manipulation):
+ *   parameters:  schedule  the expanded key
+ *                rounds    the number of rounds
+ *                encrypt   true to encrypt, false to decrypt
+ *                iv        the chaining value, updated on return
+ *                in        input data
+ *                inOff     offset of the input data
+ *                len       number of bytes, a multiple of 16
+ *                out       output buffer
+ *                outOff    offset of the output data
+ *   returns: nothing
+ *=======================================================================*/
+KNIEXPORT KNI_RETURNTYPE_VOID
+Java_com_sun_midp_crypto_NativeAESCBC_cbc() {
+    jint rounds = KNI_GetParameterAsInt(2);
+    jboolean encrypt = KNI_GetParameterAsBoolean(3);
+    jint inOff = KNI_GetParameterAsInt(6);
+    jint len = KNI_GetParameterAsInt(7);
+    jint outOff = KNI_GetParameterAsInt(9);
+    unsigned char *w, *iv, *in, *out;
+
+    KNI_StartHandles(4);
+    KNI_DeclareHandle(ischedule);
+    KNI_DeclareHandle(iiv);
+    KNI_DeclareHandle(iin);
+    KNI_DeclareHandle(iout);
+
+    KNI_GetParameterAsObject(1, ischedule);
+    KNI_GetParameterAsObject(4, iiv);
+    KNI_GetParameterAsObject(5, iin);
+    KNI_GetParameterAsObject(8, iout);
+
+    /*
+     * Bounds were checked at Java level. Nothing below can trigger a GC,
+     * so the arrays are worked on in place.
+     */
+    w = (unsigned char*)SNI_GetRawArrayPointer(ischedule);
+    iv = (unsigned char*)SNI_GetRawArrayPointer(iiv);
+    in = (unsigned char*)SNI_GetRawArrayPointer(iin) + inOff;
+    out = (unsigned char*)SNI_GetRawArrayPointer(iout) + outOff;
+
+#if AES_USE_AESNI
+    if (aesni_available()) {
+        aesni_cbc(w, rounds, encrypt, iv, in, out, len);
+    } else
+#endif
+    {
+        aes_cbc(w, rounds, encrypt, iv, in, out, len);
+    }
+
+    KNI_EndHandles();
+    KNI_ReturnVoid();
+}
@@ -43,6 +43,7 @@
 #include <bn.h>
 #if ENABLE_PCSL
 #include <javacall_security.h>
+#include <javacall_os.h>
 #include <pcsl_memory.h>
 #endif
 
@@ -58,6 +59,8 @@ typedef struct {
 	int resLen;
 	int maxLen;
 	BIGNUM* d;
+	/* Signal the calculation completes with, if not done synchronously */
+	int waitingFor;
 }BN_MODEXP_OPER_HANDLE;
 
 
@@ -153,7 +156,7 @@ Java_com_sun_midp_crypto_RSA_modExp() {
 						BN_mod_exp_mont_finish(handle);
 					} else {
 						waitFlag = 1;
-						SNIEVT_wait(BN_CALC_COMP_SIGNAL, (int)handle, 0);
+						SNIEVT_wait(handle->waitingFor, (int)handle, 0);
 					}
 				} else {
 					pcsl_mem_free(bufMod);
@@ -195,6 +198,11 @@ Java_com_sun_midp_crypto_RSA_modExp() {
 
 #if ENABLE_PCSL
 
+/* Runs on a javacall worker thread, must not call KNI */
+static void BN_mod_exp_mont_offload(void* handle) {
+	BN_mod_exp_mont_do((BN_MODEXP_OPER_HANDLE*)handle);
+}
+
 static BN_MODEXP_OPER_HANDLE* BN_mod_exp_mont_start(unsigned char* bufData, int dataLen, 
 	                                                  unsigned char* bufExp, int expLen, 
 	                                                  unsigned char* bufMod, int modLen,
@@ -215,9 +223,16 @@ static BN_MODEXP_OPER_HANDLE* BN_mod_exp_mont_start(unsigned char* bufData, int
 	handle->resLen = resLen;
 	handle->maxLen = maxLen;
 	handle->d = NULL;
+	handle->waitingFor = BN_CALC_COMP_SIGNAL;
 
 	res = javacall_secure_modexp(handle);
 	if (JAVACALL_NOT_IMPLEMENTED== res) {
+		/* Calculate on a worker thread, so only the caller blocks */
+		handle->waitingFor = OFFLOAD_SIGNAL;
+		if (JAVACALL_WOULD_BLOCK ==
+				javacall_os_offload(BN_mod_exp_mont_offload, handle)) {
+			return handle;
+		}
 		BN_mod_exp_mont_do(handle);
 		if (handle->d == NULL) {
 			pcsl_mem_free(handle);
@@ -0,0 +1,483 @@
+/*
+ * Copyright (C) Max Mu
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * Please visit www.joshvm.org if you need additional information or
+ * have any questions.
+ */
+
+/**
+ * @file
+ *
+ * Native SHA-1, SHA-256 and SHA-512 compression functions for
+ * com.sun.midp.crypto.NativeSHADigest.
+ *
+ * Any number of whole blocks is hashed per call; padding and buffering
+ * of partial blocks is done in Java. The chaining value is kept in a
+ * Java byte array in big endian order. On x86 built with GCC 5 or newer
+ * the SHA extensions are used for SHA-1 and SHA-256 when the CPU has
+ * them.
+ */
+
+#include <kni.h>
+#include <sni.h>
+#include <stdint.h>
+
+/* Must match the algorithm identifiers in NativeSHADigest.java */
+#define DIGEST_SHA1   1
+#define DIGEST_SHA256 2
+#define DIGEST_SHA512 3
+
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__)) && \
+    __GNUC__ >= 5
+#define DIGEST_USE_SHANI 1
+#include <cpuid.h>
+#include <immintrin.h>
+#else
+#define DIGEST_USE_SHANI 0
+#endif
+
+#define ROTL32(x, n) (((x) << (n)) | ((x) >> (32 - (n))))
+#define ROTR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+#define ROTR64(x, n) (((x) >> (n)) | ((x) << (64 - (n))))
+
+static uint32_t load_be32(const unsigned char* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) |
+           ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static void store_be32(unsigned char* p, uint32_t v) {
+    p[0] = (unsigned char)(v >> 24);
+    p[1] = (unsigned char)(v >> 16);
+    p[2] = (unsigned char)(v >> 8);
+    p[3] = (unsigned char)v;
+}
+
+static uint64_t load_be64(const unsigned char* p) {
+    return ((uint64_t)load_be32(p) << 32) | load_be32(p + 4);
+}
+
+static void store_be64(unsigned char* p, uint64_t v) {
+    store_be32(p, (uint32_t)(v >> 32));
+    store_be32(p + 4, (uint32_t)v);
+}
+
+static const uint32_t K256[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+    0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+    0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+    0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+    0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+    0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+    0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+    0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+    0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint64_t K512[80] = {
+    UINT64_C(0x428a2f98d728ae22), UINT64_C(0x7137449123ef65cd),
+    UINT64_C(0xb5c0fbcfec4d3b2f), UINT64_C(0xe9b5dba58189dbbc),
+    UINT64_C(0x3956c25bf348b538), UINT64_C(0x59f111f1b605d019),
+    UINT64_C(0x923f82a4af194f9b), UINT64_C(0xab1c5ed5da6d8118),
+    UINT64_C(0xd807aa98a3030242), UINT64_C(0x12835b0145706fbe),
+    UINT64_C(0x243185be4ee4b28c), UINT64_C(0x550c7dc3d5ffb4e2),
+    UINT64_C(0x72be5d74f27b896f), UINT64_C(0x80deb1fe3b1696b1),
+    UINT64_C(0x9bdc06a725c71235), UINT64_C(0xc19bf174cf692694),
+    UINT64_C(0xe49b69c19ef14ad2), UINT64_C(0xefbe4786384f25e3),
+    UINT64_C(0x0fc19dc68b8cd5b5), UINT64_C(0x240ca1cc77ac9c65),
+    UINT64_C(0x2de92c6f592b0275), UINT64_C(0x4a7484aa6ea6e483),
+    UINT64_C(0x5cb0a9dcbd41fbd4), UINT64_C(0x76f988da831153b5),
+    UINT64_C(0x983e5152ee66dfab), UINT64_C(0xa831c66d2db43210),
+    UINT64_C(0xb00327c898fb213f), UINT64_C(0xbf597fc7beef0ee4),
+    UINT64_C(0xc6e00bf33da88fc2), UINT64_C(0xd5a79147930aa725),
+    UINT64_C(0x06ca6351e003826f), UINT64_C(0x142929670a0e6e70),
+    UINT64_C(0x27b70a8546d22ffc), UINT64_C(0x2e1b21385c26c926),
+    UINT64_C(0x4d2c6dfc5ac42aed), UINT64_C(0x53380d139d95b3df),
+    UINT64_C(0x650a73548baf63de), UINT64_C(0x766a0abb3c77b2a8),
+    UINT64_C(0x81c2c92e47edaee6), UINT64_C(0x92722c851482353b),
+    UINT64_C(0xa2bfe8a14cf10364), UINT64_C(0xa81a664bbc423001),
+    UINT64_C(0xc24b8b70d0f89791), UINT64_C(0xc76c51a30654be30),
+    UINT64_C(0xd192e819d6ef5218), UINT64_C(0xd69906245565a910),
+    UINT64_C(0xf40e35855771202a), UINT64_C(0x106aa07032bbd1b8),
+    UINT64_C(0x19a4c116b8d2d0c8), UINT64_C(0x1e376c085141ab53),
+    UINT64_C(0x2748774cdf8eeb99), UINT64_C(0x34b0bcb5e19b48a8),
+    UINT64_C(0x391c0cb3c5c95a63), UINT64_C(0x4ed8aa4ae3418acb),
+    UINT64_C(0x5b9cca4f7763e373), UINT64_C(0x682e6ff3d6b2b8a3),
+    UINT64_C(0x748f82ee5defb2fc), UINT64_C(0x78a5636f43172f60),
+    UINT64_C(0x84c87814a1f0ab72), UINT64_C(0x8cc702081a6439ec),
+    UINT64_C(0x90befffa23631e28), UINT64_C(0xa4506cebde82bde9),
+    UINT64_C(0xbef9a3f7b2c67915), UINT64_C(0xc67178f2e372532b),
+    UINT64_C(0xca273eceea26619c), UINT64_C(0xd186b8c721c0c207),
+    UINT64_C(0xeada7dd6cde0eb1e), UINT64_C(0xf57d4f7fee6ed178),
+    UINT64_C(0x06f067aa72176fba), UINT64_C(0x0a637dc5a2c898a6),
+    UINT64_C(0x113f9804bef90dae), UINT64_C(0x1b710b35131c471b),
+    UINT64_C(0x28db77f523047d84), UINT64_C(0x32caab7b40c72493),
+    UINT64_C(0x3c9ebe0a15c9bebc), UINT64_C(0x431d67c49c100d4c),
+    UINT64_C(0x4cc5d4becb3e42b6), UINT64_C(0x597f299cfc657e2a),
+    UINT64_C(0x5fcb6fab3ad6faec), UINT64_C(0x6c44198c4a475817)
+};
+
+/* The message schedule is kept as a rolling window of 16 words */
+
+static void sha1_blocks(uint32_t* h, const unsigned char* in, int blocks) {
+    uint32_t w[16];
+    uint32_t a, b, c, d, e, f, k, t;
+    int i;
+
+    while (blocks-- > 0) {
+        a = h[0]; b = h[1]; c = h[2]; d = h[3]; e = h[4];
+
+        for (i = 0; i < 80; i++) {
+            if (i < 16) {
+                w[i] = load_be32(in + 4 * i);
+            } else {
+                t = w[(i - 3) & 15] ^ w[(i - 8) & 15] ^
+                    w[(i - 14) & 15] ^ w[i & 15];
+                w[i & 15] = ROTL32(t, 1);
+            }
+
+            if (i < 20) {
+                f = (b & c) | (~b & d);
+                k = 0x5a827999;
+            } else if (i < 40) {
+                f = b ^ c ^ d;
+                k = 0x6ed9eba1;
+            } else if (i < 60) {
+                f = (b & c) | (b & d) | (c & d);
+                k = 0x8f1bbcdc;
+            } else {
+                f = b ^ c ^ d;
+                k = 0xca62c1d6;
+            }
+
+            t = ROTL32(a, 5) + f + e + k + w[i & 15];
+            e = d; d = c; c = ROTL32(b, 30); b = a; a = t;
+        }
+
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d; h[4] += e;
+        in += 64;
+    }
+}
+
+static void sha256_blocks(uint32_t* h, const unsigned char* in, int blocks) {
+    uint32_t w[16];
+    uint32_t a, b, c, d, e, f, g, hh, s0, s1, t1, t2;
+    int i;
+
+    while (blocks-- > 0) {
+        a = h[0]; b = h[1]; c = h[2]; d = h[3];
+        e = h[4]; f = h[5]; g = h[6]; hh = h[7];
+
+        for (i = 0; i < 64; i++) {
+            if (i < 16) {
+                w[i] = load_be32(in + 4 * i);
+            } else {
+                s0 = w[(i - 15) & 15];
+                s0 = ROTR32(s0, 7) ^ ROTR32(s0, 18) ^ (s0 >> 3);
+                s1 = w[(i - 2) & 15];
+                s1 = ROTR32(s1, 17) ^ ROTR32(s1, 19) ^ (s1 >> 10);
+                w[i & 15] += s0 + w[(i - 7) & 15] + s1;
+            }
+
+            t1 = hh + (ROTR32(e, 6) ^ ROTR32(e, 11) ^ ROTR32(e, 25)) +
+                 ((e & f) ^ (~e & g)) + K256[i] + w[i & 15];
+            t2 = (ROTR32(a, 2) ^ ROTR32(a, 13) ^ ROTR32(a, 22)) +
+                 ((a & b) ^ (a & c) ^ (b & c));
+            hh = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+        h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
+        in += 64;
+    }
+}
+
+static void sha512_blocks(uint64_t* h, const unsigned char* in, int blocks) {
+    uint64_t w[16];
+    uint64_t a, b, c, d, e, f, g, hh, s0, s1, t1, t2;
+    int i;
+
+    while (blocks-- > 0) {
+        a = h[0]; b = h[1]; c = h[2]; d = h[3];
+        e = h[4]; f = h[5]; g = h[6]; hh = h[7];
+
+        for (i = 0; i < 80; i++) {
+            if (i < 16) {
+                w[i] = load_be64(in + 8 * i);
+            } else {
+                s0 = w[(i - 15) & 15];
+                s0 = ROTR64(s0, 1) ^ ROTR64(s0, 8) ^ (s0 >> 7);
+                s1 = w[(i - 2) & 15];
+                s1 = ROTR64(s1, 19) ^ ROTR64(s1, 61) ^ (s1 >> 6);
+                w[i & 15] += s0 + w[(i - 7) & 15] + s1;
+            }
+
+            t1 = hh + (ROTR64(e, 14) ^ ROTR64(e, 18) ^ ROTR64(e, 41)) +
+                 ((e & f) ^ (~e & g)) + K512[i] + w[i & 15];
+            t2 = (ROTR64(a, 28) ^ ROTR64(a, 34) ^ ROTR64(a, 39)) +
+                 ((a & b) ^ (a & c) ^ (b & c));
+            hh = g; g = f; f = e; e = d + t1;
+            d = c; c = b; b = a; a = t1 + t2;
+        }
+
+        h[0] += a; h[1] += b; h[2] += c; h[3] += d;
+        h[4] += e; h[5] += f; h[6] += g; h[7] += hh;
+        in += 128;
+    }
+}
+
+#if DIGEST_USE_SHANI
+
+static int shani_available(void) {
+    static int available = -1;
+    unsigned int a, b, c, d;
+
+    if (available < 0) {
+        available = __get_cpuid_max(0, NULL) >= 7 &&
+                    __get_cpuid(1, &a, &b, &c, &d) &&
+                    (c & bit_SSE4_1) != 0;
+        if (available) {
+            __cpuid_count(7, 0, a, b, c, d);
+            available = (b & (1 << 29)) != 0;
+        }
+    }
+    return available;
+}
+
+__attribute__((target("sha,sse4.1")))
+static void sha1_blocks_shani(uint32_t* h, const unsigned char* in,
+                              int blocks) {
+    const __m128i mask = _mm_set_epi64x(0x0001020304050607ULL,
+                                        0x08090a0b0c0d0e0fULL);
+    __m128i abcd, abcd_save, e0, e0_save, e1;
+    __m128i m[4];
+    int i;
+
+    abcd = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)h), 0x1b);
+    e0 = _mm_set_epi32(h[4], 0, 0, 0);
+
+    while (blocks-- > 0) {
+        abcd_save = abcd;
+        e0_save = e0;
+
+        for (i = 0; i < 4; i++) {
+            m[i] = _mm_shuffle_epi8(
+                _mm_loadu_si128((const __m128i*)(in + 16 * i)), mask);
+        }
+
+        /* 20 groups of 4 rounds; E alternates between e0 and e1 */
+        for (i = 0; i < 20; i++) {
+            if (i == 0) {
+                e0 = _mm_add_epi32(e0, m[0]);
+                e1 = abcd;
+            } else if (i & 1) {
+                e1 = _mm_sha1nexte_epu32(e1, m[i & 3]);
+                e0 = abcd;
+            } else {
+                e0 = _mm_sha1nexte_epu32(e0, m[i & 3]);
+                e1 = abcd;
+            }
+
+            if (i >= 3 && i <= 18) {
+                m[(i + 1) & 3] = _mm_sha1msg2_epu32(m[(i + 1) & 3], m[i & 3]);
+            }
+
+            switch (i / 5) {
+            case 0:
+                abcd = _mm_sha1rnds4_epu32(abcd, (i & 1) ? e1 : e0, 0);
+                break;
+            case 1:
+                abcd = _mm_sha1rnds4_epu32(abcd, (i & 1) ? e1 : e0, 1);
+                break;
+            case 2:
+                abcd = _mm_sha1rnds4_epu32(abcd, (i & 1) ? e1 : e0, 2);
+                break;
+            default:
+                abcd = _mm_sha1rnds4_epu32(abcd, (i & 1) ? e1 : e0, 3);
+                break;
+            }
+
+            if (i >= 1 && i <= 16) {
+                m[(i - 1) & 3] = _mm_sha1msg1_epu32(m[(i - 1) & 3], m[i & 3]);
+            }
+            if (i >= 2 && i <= 17) {
+                m[(i - 2) & 3] = _mm_xor_si128(m[(i - 2) & 3], m[i & 3]);
+            }
+        }
+
+        e0 = _mm_sha1nexte_epu32(e0, e0_save);
+        abcd = _mm_add_epi32(abcd, abcd_save);
+        in += 64;
+    }
+
+    _mm_storeu_si128((__m128i*)h, _mm_shuffle_epi32(abcd, 0x1b));
+    h[4] = (uint32_t)_mm_extract_epi32(e0, 3);
+}
+
+__attribute__((target("sha,sse4.1")))
+static void sha256_blocks_shani(uint32_t* h, const unsigned char* in,
+                                int blocks) {
+    const __m128i mask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL,
+                                        0x0405060700010203ULL);
+    __m128i state0, state1, abef_save, cdgh_save, msg, tmp;
+    __m128i m[4];
+    int i;
+
+    /* Rearrange the state into the ABEF/CDGH layout of the instructions */
+    tmp = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)h), 0xb1);
+    state1 = _mm_shuffle_epi32(_mm_loadu_si128((const __m128i*)(h + 4)), 0x1b);
+    state0 = _mm_alignr_epi8(tmp, state1, 8);
+    state1 = _mm_blend_epi16(state1, tmp, 0xf0);
+
+    while (blocks-- > 0) {
+        abef_save = state0;
+        cdgh_save = state1;
+
+        for (i = 0; i < 4; i++) {
+            m[i] = _mm_shuffle_epi8(
+                _mm_loadu_si128((const __m128i*)(in + 16 * i)), mask);
+        }
+
+        /* 16 groups of 4 rounds */
+        for (i = 0; i < 16; i++) {
+            msg = _mm_add_epi32(m[i & 3],
+                                _mm_loadu_si128((const __m128i*)(K256 + 4 * i)));
+            state1 = _mm_sha256rnds2_epu32(state1, state0, msg);
+
+            if (i >= 3 && i <= 14) {
+                tmp = _mm_alignr_epi8(m[i & 3], m[(i - 1) & 3], 4);
+                m[(i + 1) & 3] = _mm_add_epi32(m[(i + 1) & 3], tmp);
+                m[(i + 1) & 3] = _mm_sha256msg2_epu32(m[(i + 1) & 3], m[i & 3]);
+            }
+
+            msg = _mm_shuffle_epi32(msg, 0x0e);
+            state0 = _mm_sha256rnds2_epu32(state0, state1, msg);
+
+            if (i >= 1 && i <= 12) {
+                m[(i - 1) & 3] = _mm_sha256msg1_epu32(m[(i - 1) & 3], m[i & 3]);
+            }
+        }
+
+        state0 = _mm_add_epi32(state0, abef_save);
+        state1 = _mm_add_epi32(state1, cdgh_save);
+        in += 64;
+    }
+
+    tmp = _mm_shuffle_epi32(state0, 0x1b);
+    state1 = _mm_shuffle_epi32(state1, 0xb1);
+    state0 = _mm_blend_epi16(tmp, state1, 0xf0);
+    state1 = _mm_alignr_epi8(state1, tmp, 8);
+
+    _mm_storeu_si128((__m128i*)h, state0);
+    _mm_storeu_si128((__m128i*)(h + 4), state1);
+}
+
+#endif
+
+/*=========================================================================
+ * FUNCTION:      compress(I[B[BII)V (STATIC)
+ * CLASS:         com/sun/midp/crypto/NativeSHADigest
+ * TYPE:          static native function
+ * OVERVIEW:      Run the compression function over whole blocks.
+ * INTERFACE (operand stack manipulation):
+ *   parameters:  algorithm  DIGEST_SHA1, DIGEST_SHA256 or DIGEST_SHA512
+ *                state      the big endian chaining value, updated
+ *                in         input data
+ *                inOff      offset of the first block
+ *                blocks     number of blocks
+ *   returns: nothing
+ *=======================================================================*/
+KNIEXPORT KNI_RETURNTYPE_VOID
+Java_com_sun_midp_crypto_NativeSHADigest_compress() {
+    jint algorithm = KNI_GetParameterAsInt(1);
+    jint inOff = KNI_GetParameterAsInt(4);
+    jint blocks = KNI_GetParameterAsInt(5);
+    unsigned char *state, *in;
+    uint32_t h32[8];
+    uint64_t h64[8];
+    int i;
+
+    KNI_StartHandles(2);
+    KNI_DeclareHandle(istate);
+    KNI_DeclareHandle(iin);
+
+    KNI_GetParameterAsObject(2, istate);
+    KNI_GetParameterAsObject(3, iin);
+
+    /*
+     * Bounds were checked at Java level. Nothing below can trigger a GC,
+     * so the input is hashed in place.
+     */
+    state = (unsigned char*)SNI_GetRawArrayPointer(istate);
+    in = (unsigned char*)SNI_GetRawArrayPointer(iin) + inOff;
+
+    switch (algorithm) {
+    case DIGEST_SHA1:
+        for (i = 0; i < 5; i++) {
+            h32[i] = load_be32(state + 4 * i);
+        }
+#if DIGEST_USE_SHANI
+        if (shani_available()) {
+            sha1_blocks_shani(h32, in, blocks);
+        } else
+#endif
+        {
+            sha1_blocks(h32, in, blocks);
+        }
+        for (i = 0; i < 5; i++) {
+            store_be32(state + 4 * i, h32[i]);
+        }
+        break;
+
+    case DIGEST_SHA256:
+        for (i = 0; i < 8; i++) {
+            h32[i] = load_be32(state + 4 * i);
+        }
+#if DIGEST_USE_SHANI
+        if (shani_available()) {
+            sha256_blocks_shani(h32, in, blocks);
+        } else
+#endif
+        {
+            sha256_blocks(h32, in, blocks);
+        }
+        for (i = 0; i < 8; i++) {
+            store_be32(state + 4 * i, h32[i]);
+        }
+        break;
+
+    case DIGEST_SHA512:
+        for (i = 0; i < 8; i++) {
+            h64[i] = load_be64(state + 8 * i);
+        }
+        sha512_blocks(h64, in, blocks);
+        for (i = 0; i < 8; i++) {
+            store_be64(state + 8 * i, h64[i]);
+        }
+        break;
+    }
+
+    KNI_EndHandles();
+    KNI_ReturnVoid();
+}
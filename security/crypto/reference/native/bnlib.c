@@ -1139,23 +1139,138 @@ void bn_sqr_words(BN_ULONG *r, BN_ULONG *a, short n)
 }
 
 
+/*
+ * Montgomery arithmetic for BN_mod_exp_mont. It works on plain arrays of
+ * the widest word the compiler can multiply into a double word, rather
+ * than on the 16 bit BN_ULONG limbs used by the rest of this file.
+ */
+#if defined(__SIZEOF_INT128__)
+typedef unsigned long long BN_MONT_ULONG;
+typedef unsigned __int128 BN_MONT_ULLONG;
+#else
+typedef unsigned int BN_MONT_ULONG;
+typedef unsigned long long BN_MONT_ULLONG;
+#endif
+
+#define BN_MONT_BITS  ((int)(sizeof(BN_MONT_ULONG) * 8))
+#define BN_MONT_LIMBS (BN_MONT_BITS / BN_BITS2)
+
+/* Returns -n0^-1 mod 2^BN_MONT_BITS for odd n0 */
+static BN_MONT_ULONG mont_n0(BN_MONT_ULONG n0)
+{
+    BN_MONT_ULONG inv = 1;
+    int i;
+
+    /* Each Newton step doubles the number of correct low bits */
+    for (i = 0; i < 6; i++)
+        inv *= 2 - n0 * inv;
+
+    return (BN_MONT_ULONG)0 - inv;
+}
+
+/*
+ * r = a * b / R mod n, interleaving multiplication and reduction (CIOS).
+ * r may be the same as a or b. t must hold nl+2 words.
+ */
+static void mont_mul(BN_MONT_ULONG *r, const BN_MONT_ULONG *a, const BN_MONT_ULONG *b,
+                     const BN_MONT_ULONG *n, BN_MONT_ULONG n0, int nl, BN_MONT_ULONG *t)
+{
+    BN_MONT_ULLONG uv;
+    BN_MONT_ULONG c, m, x, y, borrow;
+    int i, j;
+
+    memset(t, 0, (nl + 2) * sizeof(BN_MONT_ULONG));
+
+    for (i = 0; i < nl; i++)
+        {
+        c = 0;
+        for (j = 0; j < nl; j++)
+            {
+            uv = (BN_MONT_ULLONG)a[j] * b[i] + t[j] + c;
+            t[j] = (BN_MONT_ULONG)uv;
+            c = (BN_MONT_ULONG)(uv >> BN_MONT_BITS);
+            }
+        uv = (BN_MONT_ULLONG)t[nl] + c;
+        t[nl] = (BN_MONT_ULONG)uv;
+        t[nl + 1] = (BN_MONT_ULONG)(uv >> BN_MONT_BITS);
+
+        m = t[0] * n0;
+        uv = (BN_MONT_ULLONG)m * n[0] + t[0];
+        c = (BN_MONT_ULONG)(uv >> BN_MONT_BITS);
+        for (j = 1; j < nl; j++)
+            {
+            uv = (BN_MONT_ULLONG)m * n[j] + t[j] + c;
+            t[j - 1] = (BN_MONT_ULONG)uv;
+            c = (BN_MONT_ULONG)(uv >> BN_MONT_BITS);
+            }
+        uv = (BN_MONT_ULLONG)t[nl] + c;
+        t[nl - 1] = (BN_MONT_ULONG)uv;
+        t[nl] = t[nl + 1] + (BN_MONT_ULONG)(uv >> BN_MONT_BITS);
+        }
+
+    /* t < 2n, so at most one subtraction is needed */
+    if (t[nl] == 0)
+        {
+        for (j = nl - 1; j >= 0 && t[j] == n[j]; j--)
+            ;
+        if (j >= 0 && t[j] < n[j])
+            {
+            memcpy(r, t, nl * sizeof(BN_MONT_ULONG));
+            return;
+            }
+        }
+
+    borrow = 0;
+    for (j = 0; j < nl; j++)
+        {
+        x = t[j];
+        y = n[j];
+        r[j] = x - y - borrow;
+        borrow = (x < y) | ((x == y) & borrow);
+        }
+}
+
+static void bn_to_mont_words(BN_MONT_ULONG *w, BIGNUM *a, int nl)
+{
+    int i;
+
+    memset(w, 0, nl * sizeof(BN_MONT_ULONG));
+    for (i = 0; i < a->top && i < nl * BN_MONT_LIMBS; i++)
+        w[i / BN_MONT_LIMBS] |=
+            (BN_MONT_ULONG)a->d[i] << ((i % BN_MONT_LIMBS) * BN_BITS2);
+}
+
+static INTEGER bn_from_mont_words(BIGNUM *r, BN_MONT_ULONG *w, int nl)
+{
+    int i, top = nl * BN_MONT_LIMBS;
+
+    if (bn_expand(r, (INTEGER)(top * BN_BITS2)) == NULL) return(0);
+    for (i = 0; i < top; i++)
+        r->d[i] = (BN_ULONG)((w[i / BN_MONT_LIMBS] >>
+                              ((i % BN_MONT_LIMBS) * BN_BITS2)) & BN_MASK2);
+    r->top = top;
+    r->neg = 0;
+    bn_fix_top(r);
+    return(1);
+}
+
 /* Returns true for success, false for error. */
 INTEGER BN_mod_exp_mont(BIGNUM *r,BIGNUM *a,BIGNUM *p,BIGNUM *m,BN_CTX *ctx)
 {
-        INTEGER i,j,bits,ret=0,wstart,wend,window,wvalue;
+        INTEGER i,bits,ret=0,wstart,wend,window,wvalue;
         INTEGER start=1;
-        BIGNUM *d, *t, *aa;
-        BIGNUM *val[16];
-        BN_MONT_CTX *mont=NULL;
+        int nl, tablen;
+        size_t memlen;
+        BIGNUM *t1, *t2;
+        BN_MONT_ULONG *mem, *n, *x, *tmp, *t, *val;
+        BN_MONT_ULONG n0;
 
         if (!(m->d[0] & 1))
                 {
                 /*BNerr(BN_F_BN_MOD_EXP_MONT,BN_R_CALLED_WITH_EVEN_MODULUS);*/
                 return(0);
                 }
-        
-        d=ctx->bn[ctx->tos++];
-        t=ctx->bn[ctx->tos++];
+
         bits=BN_num_bits(p);
         if (bits == 0)
                 {
@@ -1163,65 +1278,52 @@ INTEGER BN_mod_exp_mont(BIGNUM *r,BIGNUM *a,BIGNUM *p,BIGNUM *m,BN_CTX *ctx)
                 return(1);
                 }
 
-        /* If this is not done, things will break in the montgomery
-         * part */
-
-        if ((mont=BN_MONT_CTX_new(ctx->bn[0]->byteSize)) == NULL)
-               {
-               goto err;
-               }
-
-        if (!BN_MONT_CTX_set(mont,m,ctx)) goto err;
-
-        if (BN_ucmp(a,m) >= 0)
-                {
-                BN_mod(t,a,m,ctx);
-                aa=t;
-                }
-        else    aa=a;
-
-        if (bits <= 17) {/* Probably 3 or 0x10001, so just do singles */
-                if (!BN_to_montgomery(d,aa,mont,ctx)) goto err; 
-                if (!BN_mod_mul_montgomery(r,d,d,mont,ctx)) goto err;
-        wstart =  1<< (bits = bits-2);
-                for (i=bits; i>0; i--)
-                {
-                  if (p->d[0] & wstart) {
-                     if (!BN_mod_mul_montgomery(r,r,d,mont,ctx)) goto err;
-                  }
-                  if (!BN_mod_mul_montgomery(r,r,r,mont,ctx)) goto err;
-          wstart >>= 1;
-                }
-        if (p->d[0] & wstart) {
-            if (!BN_mod_mul_montgomery(r,r,aa,mont,ctx)) goto err;
-        } else {
-            if (!BN_from_montgomery(r,r,mont,ctx)) goto err;
-        }
-        if (mont != NULL) BN_MONT_CTX_free(mont);
-        ctx->tos-=2;
-                return(ret=1);
-    }
-        else if (bits >= 256)
+        if (bits >= 256)
                 window=5;       /* max size of window */
         else if (bits >= 128)
                 window=4;
-        else
+        else if (bits > 17)
                 window=3;
+        else
+                window=1;       /* Probably 3 or 0x10001, so just do singles */
+
+        nl = (BN_num_bits(m) + BN_MONT_BITS - 1) / BN_MONT_BITS;
+        tablen = 1 << (window - 1);
+        /* n, x, tmp, the table and nl+2 words of mont_mul scratch */
+        memlen = ((4 + tablen) * nl + 2) * sizeof(BN_MONT_ULONG);
+        mem = (BN_MONT_ULONG *)pcsl_mem_malloc(memlen);
+        if (mem == NULL) return(0);
+        n = mem;
+        x = n + nl;
+        tmp = x + nl;
+        val = tmp + nl;
+        t = val + tablen * nl;
+
+        t1=ctx->bn[ctx->tos++];
+        t2=ctx->bn[ctx->tos++];
+
+        bn_to_mont_words(n, m, nl);
+        n0 = mont_n0(n[0]);
+
+        /* val[0] = aR mod m */
+        if (!BN_lshift(t1, a, (INTEGER)(nl * BN_MONT_BITS))) goto err;
+        if (!BN_mod(t2, t1, m, ctx)) goto err;
+        bn_to_mont_words(val, t2, nl);
+
+        /* x = R mod m, which is 1 in Montgomery form */
+        if (!BN_lshift(t1, BN_value_one(), (INTEGER)(nl * BN_MONT_BITS)))
+                goto err;
+        if (!BN_mod(t2, t1, m, ctx)) goto err;
+        bn_to_mont_words(x, t2, nl);
 
-        val[0]=BN_new(ctx->bn[0]->byteSize);
-        if (val[0] == NULL) goto err;
-        if (!BN_to_montgomery(val[0],aa,mont,ctx)) goto err; /* 1 */
-        if (!BN_mod_mul_montgomery(d,val[0],val[0],mont,ctx)) goto err; 
-        j=1<<(window-1);
-        for (i=1; i<j; i++)
+        /* val[i] = a^(2i+1) */
+        if (tablen > 1)
                 {
-                val[i]=BN_new(ctx->bn[0]->byteSize);
-                if (val[i] == NULL) goto err;
-                if (!BN_mod_mul_montgomery(val[i],val[i-1],d,mont,ctx))
-                        goto err;
+                mont_mul(tmp, val, val, n, n0, nl, t);
+                for (i=1; i<tablen; i++)
+                        mont_mul(val + i * nl, val + (i - 1) * nl, tmp,
+                                 n, n0, nl, t);
                 }
-        for (; i<16; i++)
-                val[i]=NULL;
 
         start=1;        /* This is used to avoid multiplication etc
                          * when there is only the value '1' in the
@@ -1230,14 +1332,12 @@ INTEGER BN_mod_exp_mont(BIGNUM *r,BIGNUM *a,BIGNUM *p,BIGNUM *m,BN_CTX *ctx)
         wstart=bits-1;  /* The top bit of the window */
         wend=0;         /* The bottom bit of the window */
 
-        if (!BN_to_montgomery(r,BN_value_one(),mont,ctx)) goto err;
         for (;;)
                 {
                 if (BN_is_bit_set(p,wstart) == 0)
                         {
                         if (!start)
-                                if (!BN_mod_mul_montgomery(r,r,r,mont,ctx))
-                                goto err;
+                                mont_mul(x, x, x, n, n0, nl, t);
                         if (wstart == 0) break;
                         wstart--;
                         continue;
@@ -1246,7 +1346,6 @@ INTEGER BN_mod_exp_mont(BIGNUM *r,BIGNUM *a,BIGNUM *p,BIGNUM *m,BN_CTX *ctx)
                  * how bit a window to do.  To do this we need to scan
                  * forward until the last set bit before the end of the
                  * window */
-                j=wstart;
                 wvalue=1;
                 wend=0;
                 for (i=1; i<window; i++)
@@ -1260,19 +1359,13 @@ INTEGER BN_mod_exp_mont(BIGNUM *r,BIGNUM *a,BIGNUM *p,BIGNUM *m,BN_CTX *ctx)
                                 }
                         }
 
-                /* wend is the size of the current window */
-                j=wend+1;
                 /* add the 'bytes above' */
                 if (!start)
-                        for (i=0; i<j; i++)
-                                {
-                                if (!BN_mod_mul_montgomery(r,r,r,mont,ctx))
-                                        goto err;
-                                }
+                        for (i=0; i<=wend; i++)
+                                mont_mul(x, x, x, n, n0, nl, t);
 
                 /* wvalue will be an odd number < 2^window */
-                if (!BN_mod_mul_montgomery(r,r,val[wvalue>>1],mont,ctx))
-                        goto err;
+                mont_mul(x, x, val + (wvalue >> 1) * nl, n, n0, nl, t);
 
                 /* move the 'window' down further */
                 wstart-=wend+1;
@@ -1280,13 +1373,18 @@ INTEGER BN_mod_exp_mont(BIGNUM *r,BIGNUM *a,BIGNUM *p,BIGNUM *m,BN_CTX *ctx)
                 start=0;
                 if (wstart < 0) break;
                 }
-        BN_from_montgomery(r,r,mont,ctx);
-        ret=1;
+
+        /* Leave Montgomery form by multiplying with plain 1 */
+        memset(tmp, 0, nl * sizeof(BN_MONT_ULONG));
+        tmp[0] = 1;
+        mont_mul(x, x, tmp, n, n0, nl, t);
+
+        ret=bn_from_mont_words(r, x, nl);
 err:
-        if (mont != NULL) BN_MONT_CTX_free(mont);
         ctx->tos-=2;
-        for (i=0; i<16; i++)
-                if (val[i] != NULL) BN_clear_free(val[i]);
+        /* The table holds powers of possibly secret data */
+        memset(mem, 0, memlen);
+        pcsl_mem_free(mem);
         return(ret);
 }
 
@@ -0,0 +1,179 @@
+/*
+ * Copyright (C) Max Mu
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * Please visit www.joshvm.org if you need additional information or
+ * have any questions.
+ */
+
+package com.sun.midp.crypto;
+
+import org.bouncycastle.crypto.CipherParameters;
+import org.bouncycastle.crypto.DataLengthException;
+import org.bouncycastle.crypto.MultiBlockCipher;
+import org.bouncycastle.crypto.OutputLengthException;
+import org.bouncycastle.crypto.params.KeyParameter;
+import org.bouncycastle.crypto.params.ParametersWithIV;
+
+/**
+ * AES in CBC mode, implemented natively. Any number of blocks is
+ * encrypted or decrypted in one native call, so a TLS record costs a
+ * single transition instead of one Java AES round function per block.
+ */
+public final class NativeAESCBC implements MultiBlockCipher {
+    /** AES block size in bytes. */
+    private static final int BLOCK_SIZE = 16;
+
+    /** Size of the largest (AES-256) expanded key in bytes. */
+    private static final int MAX_SCHEDULE_SIZE = 240;
+
+    /** Expanded key, filled in by the native code. */
+    private final byte[] schedule = new byte[MAX_SCHEDULE_SIZE];
+
+    /** Number of AES rounds, 0 until a key has been set. */
+    private int rounds;
+
+    /** Initialisation vector given to init(). */
+    private final byte[] IV = new byte[BLOCK_SIZE];
+
+    /** Current chaining value. */
+    private final byte[] cbcV = new byte[BLOCK_SIZE];
+
+    /** True when initialised for encryption. */
+    private boolean encrypting;
+
+    /**
+     * Expands an AES key.
+     *
+     * @param key      the 16, 24 or 32 byte key
+     * @param schedule receives the expanded key
+     * @return         the number of rounds for this key length
+     */
+    private static native int expandKey(byte[] key, byte[] schedule);
+
+    /**
+     * Encrypts or decrypts whole blocks in CBC mode. The input and
+     * output regions may be the same.
+     *
+     * @param schedule the expanded key
+     * @param rounds   the number of rounds
+     * @param encrypt  true to encrypt, false to decrypt
+     * @param iv       the chaining value, updated on return
+     * @param in       input data
+     * @param inOff    offset of the input data
+     * @param len      number of bytes to process, a multiple of 16
+     * @param out      output buffer
+     * @param outOff   offset of the output data
+     */
+    private static native void cbc(byte[] schedule, int rounds,
+                                   boolean encrypt, byte[] iv,
+                                   byte[] in, int inOff, int len,
+                                   byte[] out, int outOff);
+
+    public void init(boolean forEncryption, CipherParameters params)
+        throws IllegalArgumentException {
+        boolean oldEncrypting = encrypting;
+
+        encrypting = forEncryption;
+
+        if (params instanceof ParametersWithIV) {
+            ParametersWithIV ivParam = (ParametersWithIV)params;
+            byte[] iv = ivParam.getIV();
+
+            if (iv.length != BLOCK_SIZE) {
+                throw new IllegalArgumentException(
+                    "initialisation vector must be the same length as block size");
+            }
+
+            System.arraycopy(iv, 0, IV, 0, BLOCK_SIZE);
+            params = ivParam.getParameters();
+        }
+
+        reset();
+
+        // if null, the key is reused and only the IV changed
+        if (params != null) {
+            setKey(params);
+        } else if (oldEncrypting != encrypting) {
+            throw new IllegalArgumentException(
+                "cannot change encrypting state without providing key.");
+        }
+    }
+
+    private void setKey(CipherParameters params) {
+        if (!(params instanceof KeyParameter)) {
+            throw new IllegalArgumentException(
+                "invalid parameter passed to AES init");
+        }
+
+        byte[] key = ((KeyParameter)params).getKey();
+
+        if (key.length != 16 && key.length != 24 && key.length != 32) {
+            throw new IllegalArgumentException("Key length not 128/192/256 bits.");
+        }
+
+        rounds = expandKey(key, schedule);
+    }
+
+    public String getAlgorithmName() {
+        return "AES/CBC";
+    }
+
+    public int getBlockSize() {
+        return BLOCK_SIZE;
+    }
+
+    public int getMultiBlockSize() {
+        return BLOCK_SIZE;
+    }
+
+    public int processBlock(byte[] in, int inOff, byte[] out, int outOff)
+        throws DataLengthException, IllegalStateException {
+        return processBlocks(in, inOff, 1, out, outOff);
+    }
+
+    public int processBlocks(byte[] in, int inOff, int blockCount,
+                             byte[] out, int outOff)
+        throws DataLengthException, IllegalStateException {
+        if (rounds == 0) {
+            throw new IllegalStateException("AES engine not initialised");
+        }
+
+        if (blockCount < 0 || blockCount > Integer.MAX_VALUE / BLOCK_SIZE) {
+            throw new DataLengthException("invalid block count");
+        }
+
+        int len = blockCount * BLOCK_SIZE;
+
+        if (inOff < 0 || len > in.length - inOff) {
+            throw new DataLengthException("input buffer too short");
+        }
+
+        if (outOff < 0 || len > out.length - outOff) {
+            throw new OutputLengthException("output buffer too short");
+        }
+
+        if (len > 0) {
+            cbc(schedule, rounds, encrypting, cbcV, in, inOff, len, out, outOff);
+        }
+
+        return len;
+    }
+
+    public void reset() {
+        System.arraycopy(IV, 0, cbcV, 0, BLOCK_SIZE);
+    }
+}
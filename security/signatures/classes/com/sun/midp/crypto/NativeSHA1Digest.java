@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) Max Mu
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * Please visit www.joshvm.org if you need additional information or
+ * have any questions.
+ */
+
+package com.sun.midp.crypto;
+
+import org.bouncycastle.util.Pack;
+
+/**
+ * Natively implemented SHA-1 digest.
+ */
+public final class NativeSHA1Digest extends NativeSHADigest {
+    /** Initial hash value. */
+    private static final byte[] IV = Pack.intToBigEndian(new int[] {
+        0x67452301, 0xefcdab89, 0x98badcfe, 0x10325476, 0xc3d2e1f0
+    });
+
+    public NativeSHA1Digest() {
+        super(SHA1, "SHA-1", IV, 64, 20);
+    }
+
+    NativeSHADigest create() {
+        return new NativeSHA1Digest();
+    }
+}
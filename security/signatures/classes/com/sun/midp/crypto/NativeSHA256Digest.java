@@ -0,0 +1,43 @@
+/*
+ * Copyright (C) Max Mu
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * Please visit www.joshvm.org if you need additional information or
+ * have any questions.
+ */
+
+package com.sun.midp.crypto;
+
+import org.bouncycastle.util.Pack;
+
+/**
+ * Natively implemented SHA-256 digest.
+ */
+public final class NativeSHA256Digest extends NativeSHADigest {
+    /** Initial hash value. */
+    private static final byte[] IV = Pack.intToBigEndian(new int[] {
+        0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+        0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+    });
+
+    public NativeSHA256Digest() {
+        super(SHA256, "SHA-256", IV, 64, 32);
+    }
+
+    NativeSHADigest create() {
+        return new NativeSHA256Digest();
+    }
+}
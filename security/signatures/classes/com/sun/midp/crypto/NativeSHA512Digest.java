@@ -0,0 +1,45 @@
+/*
+ * Copyright (C) Max Mu
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * Please visit www.joshvm.org if you need additional information or
+ * have any questions.
+ */
+
+package com.sun.midp.crypto;
+
+import org.bouncycastle.util.Pack;
+
+/**
+ * Natively implemented SHA-512 digest.
+ */
+public final class NativeSHA512Digest extends NativeSHADigest {
+    /** Initial hash value. */
+    private static final byte[] IV = Pack.longToBigEndian(new long[] {
+        0x6a09e667f3bcc908L, 0xbb67ae8584caa73bL,
+        0x3c6ef372fe94f82bL, 0xa54ff53a5f1d36f1L,
+        0x510e527fade682d1L, 0x9b05688c2b3e6c1fL,
+        0x1f83d9abfb41bd6bL, 0x5be0cd19137e2179L
+    });
+
+    public NativeSHA512Digest() {
+        super(SHA512, "SHA-512", IV, 128, 64);
+    }
+
+    NativeSHADigest create() {
+        return new NativeSHA512Digest();
+    }
+}
@@ -0,0 +1,212 @@
+/*
+ * Copyright (C) Max Mu
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * Please visit www.joshvm.org if you need additional information or
+ * have any questions.
+ */
+
+package com.sun.midp.crypto;
+
+import org.bouncycastle.crypto.DataLengthException;
+import org.bouncycastle.crypto.ExtendedDigest;
+import org.bouncycastle.crypto.OutputLengthException;
+import org.bouncycastle.util.Memoable;
+
+/**
+ * Base class of the natively implemented SHA digests. Data is buffered
+ * in Java up to a full block; whole blocks are handed to the native
+ * compression function in a single call per update().
+ */
+abstract class NativeSHADigest implements ExtendedDigest, Memoable {
+    /** Algorithm identifiers understood by the native code. */
+    static final int SHA1 = 1;
+    static final int SHA256 = 2;
+    static final int SHA512 = 3;
+
+    /** Algorithm identifier. */
+    private final int algorithm;
+
+    /** Algorithm name. */
+    private final String name;
+
+    /** Initial chaining value, big endian. */
+    private final byte[] iv;
+
+    /** Current chaining value, big endian. */
+    private final byte[] state;
+
+    /** Partial block. */
+    private final byte[] buf;
+
+    /** Number of bytes in the partial block. */
+    private int bufOff;
+
+    /** Number of bytes hashed so far. */
+    private long byteCount;
+
+    /** Length of the produced hash in bytes. */
+    private final int digestSize;
+
+    /**
+     * Runs the compression function over whole blocks.
+     *
+     * @param algorithm one of SHA1, SHA256 or SHA512
+     * @param state     the chaining value, updated on return
+     * @param in        input data
+     * @param inOff     offset of the first block
+     * @param blocks    number of blocks to process
+     */
+    private static native void compress(int algorithm, byte[] state,
+                                        byte[] in, int inOff, int blocks);
+
+    NativeSHADigest(int algorithm, String name, byte[] iv,
+                    int blockSize, int digestSize) {
+        this.algorithm = algorithm;
+        this.name = name;
+        this.iv = iv;
+        this.state = new byte[iv.length];
+        this.buf = new byte[blockSize];
+        this.digestSize = digestSize;
+
+        reset();
+    }
+
+    /**
+     * Creates a new, reset digest of the same algorithm.
+     *
+     * @return new digest object
+     */
+    abstract NativeSHADigest create();
+
+    public String getAlgorithmName() {
+        return name;
+    }
+
+    public int getDigestSize() {
+        return digestSize;
+    }
+
+    public int getByteLength() {
+        return buf.length;
+    }
+
+    public void update(byte in) {
+        buf[bufOff++] = in;
+        byteCount++;
+
+        if (bufOff == buf.length) {
+            compress(algorithm, state, buf, 0, 1);
+            bufOff = 0;
+        }
+    }
+
+    public void update(byte[] in, int inOff, int len) {
+        int blockSize = buf.length;
+
+        if (inOff < 0 || len < 0 || len > in.length - inOff) {
+            throw new DataLengthException("input buffer too short");
+        }
+
+        byteCount += len;
+
+        if (bufOff > 0) {
+            int n = Math.min(len, blockSize - bufOff);
+
+            System.arraycopy(in, inOff, buf, bufOff, n);
+            bufOff += n;
+            inOff += n;
+            len -= n;
+
+            if (bufOff < blockSize) {
+                return;
+            }
+
+            compress(algorithm, state, buf, 0, 1);
+            bufOff = 0;
+        }
+
+        int blocks = len / blockSize;
+        if (blocks > 0) {
+            compress(algorithm, state, in, inOff, blocks);
+            inOff += blocks * blockSize;
+            len -= blocks * blockSize;
+        }
+
+        if (len > 0) {
+            System.arraycopy(in, inOff, buf, 0, len);
+            bufOff = len;
+        }
+    }
+
+    public int doFinal(byte[] out, int outOff) {
+        int blockSize = buf.length;
+        /* SHA-512 uses a 128 bit length field, the others 64 bits */
+        int lengthSize = blockSize / 8;
+        long bitLength = byteCount << 3;
+
+        if (outOff < 0 || digestSize > out.length - outOff) {
+            throw new OutputLengthException("output buffer too short");
+        }
+
+        buf[bufOff++] = (byte)0x80;
+        if (bufOff > blockSize - lengthSize) {
+            while (bufOff < blockSize) {
+                buf[bufOff++] = 0;
+            }
+            compress(algorithm, state, buf, 0, 1);
+            bufOff = 0;
+        }
+
+        while (bufOff < blockSize - 8) {
+            buf[bufOff++] = 0;
+        }
+
+        for (int i = blockSize - 1; i >= bufOff; i--) {
+            buf[i] = (byte)bitLength;
+            bitLength >>>= 8;
+        }
+
+        compress(algorithm, state, buf, 0, 1);
+        System.arraycopy(state, 0, out, outOff, digestSize);
+
+        reset();
+
+        return digestSize;
+    }
+
+    public void reset() {
+        System.arraycopy(iv, 0, state, 0, iv.length);
+        bufOff = 0;
+        byteCount = 0;
+    }
+
+    public Memoable copy() {
+        NativeSHADigest d = create();
+
+        d.reset(this);
+        return d;
+    }
+
+    public void reset(Memoable other) {
+        NativeSHADigest d = (NativeSHADigest)other;
+
+        System.arraycopy(d.state, 0, state, 0, state.length);
+        System.arraycopy(d.buf, 0, buf, 0, d.bufOff);
+        bufOff = d.bufOff;
+        byteCount = d.byteCount;
+    }
+}
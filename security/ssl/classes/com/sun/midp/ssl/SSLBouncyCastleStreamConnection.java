@@ -26,6 +26,7 @@ import java.io.InputStream;
 import java.io.OutputStream;
 import java.io.DataInputStream;
 import java.io.DataOutputStream;
+import java.util.Hashtable;
 import java.util.Vector;
 
 import javax.microedition.io.Connector;
@@ -41,6 +42,14 @@ import org.bouncycastle.crypto.tls.TlsAuthentication;
 import org.bouncycastle.crypto.tls.TlsCredentials;
 import org.bouncycastle.crypto.tls.TlsClientProtocol;
 import org.bouncycastle.crypto.tls.CertificateRequest;
+import org.bouncycastle.crypto.tls.ExtensionType;
+import org.bouncycastle.crypto.tls.NewSessionTicket;
+import org.bouncycastle.crypto.tls.SecurityParameters;
+import org.bouncycastle.crypto.tls.SessionParameters;
+import org.bouncycastle.crypto.tls.TlsExtensionsUtils;
+import org.bouncycastle.crypto.tls.TlsSession;
+import org.bouncycastle.crypto.tls.TlsUtils;
+import org.bouncycastle.util.Integers;
 
 public class SSLBouncyCastleStreamConnection implements StreamConnection {
     /** Indicates that a is ready to be opened. */
@@ -116,33 +125,32 @@ public class SSLBouncyCastleStreamConnection implements StreamConnection {
 
         try {
             tlsproto = new TlsClientProtocol(in, out, new com.joshvm.java.security.SecureRandom());
-			DefaultTlsClient client = new DefaultTlsClient() {
-                public TlsAuthentication getAuthentication() throws IOException {
-                    TlsAuthentication auth = new TlsAuthentication() {
-                        public void notifyServerCertificate(
-                                org.bouncycastle.crypto.tls.Certificate serverCertificate)
-                                throws IOException {
-                                                                // Capture the server certificate information!
-                                certificate = serverCertificate;
-                        }
-
-                        public TlsCredentials getClientCredentials(
-                                CertificateRequest certificateRequest) throws IOException {
-                            // TODO Auto-generated method stub
-                            return null;
-                        }
-                    };
-                    return auth;
-                }
-            };
+            CachingTlsClient client =
+                new CachingTlsClient(SSLSessionCache.getSession(host, port));
 			tlsproto.connect(client);
 			if (certificate != null) {
             	org.bouncycastle.asn1.x509.Certificate[] certs = certificate.getCertificateList();
 				serverCert = new BouncyCastleX509Certificate(validateCertChain(certs));
-				cipherSuite = "TLS_RSA_WITH_AES_128_CBC_SHA"; //Hard coded for now???
+			} else if (client.resumed != null) {
+				// A resumed session proves the key of the server verified before
+				try {
+					client.resumed.serverCert.checkValidity();
+				} catch (IOException e) {
+					SSLSessionCache.removeSession(host, port);
+					throw e;
+				}
+				serverCert = new BouncyCastleX509Certificate(client.resumed.serverCert);
 			} else {
 				throw new IOException("No server certificate found!");
 			}
+			cipherSuite = "TLS_RSA_WITH_AES_128_CBC_SHA"; //Hard coded for now???
+
+			if (client.session != null) {
+				SSLSessionCache.putSession(host, port, client.session,
+					client.ticket, serverCert.getJOSHX509Certificate());
+			} else {
+				SSLSessionCache.removeSession(host, port);
+			}
 			
 			this.sin = tlsproto.getInputStream();
 			this.sout = tlsproto.getOutputStream();
@@ -155,6 +163,17 @@ public class SSLBouncyCastleStreamConnection implements StreamConnection {
     }
 
 	private X509Certificate validateCertChain(org.bouncycastle.asn1.x509.Certificate[] x509CertificateList) throws IOException {
+		byte[][] encoded = new byte[x509CertificateList.length][];
+		for (int i = 0; i < x509CertificateList.length; i++) {
+			encoded[i] = x509CertificateList[i].getEncoded();
+		}
+
+		// Skip the signature checks for a chain this server presented before
+		X509Certificate verified = SSLSessionCache.getVerifiedChain(encoded);
+		if (verified != null) {
+			return verified;
+		}
+
 		Vector certs = new Vector();
 		for (int i = 0; i < x509CertificateList.length; i++) {
 			X509Certificate x509Cert = new BouncyCastleX509Certificate(x509CertificateList[i]).getJOSHX509Certificate();
@@ -163,11 +182,113 @@ public class SSLBouncyCastleStreamConnection implements StreamConnection {
 		
 		X509Certificate.verifyChain(certs, -1,
             X509Certificate.SERVER_AUTH_EXT_KEY_USAGE, certStore);
+		SSLSessionCache.putVerifiedChain(encoded, certs);
 
         // The first cert if specified to be the server cert.
         return (X509Certificate)certs.elementAt(0);
 	}
     
+    /**
+     * TLS client that offers the cached session of the server and
+     * collects the session to cache once the handshake completes.
+     */
+    private class CachingTlsClient extends DefaultTlsClient {
+        /** Cached session offered to the server or null. */
+        private final SSLSessionCache.Entry offered;
+        /** Server extensions of a full handshake. */
+        private Hashtable serverExtensions;
+        /** Ticket received in this handshake or null. */
+        private byte[] newTicket;
+
+        /** Offered session if the server resumed it, otherwise null. */
+        SSLSessionCache.Entry resumed;
+        /** Session to cache after the handshake or null. */
+        TlsSession session;
+        /** Ticket to present with the cached session or null. */
+        byte[] ticket;
+
+        CachingTlsClient(SSLSessionCache.Entry offered) {
+            this.offered = offered;
+        }
+
+        public TlsSession getSessionToResume() {
+            return offered == null ? null : offered.session;
+        }
+
+        public Hashtable getClientExtensions() throws IOException {
+            Hashtable clientExtensions =
+                TlsExtensionsUtils.ensureExtensionsInitialised(
+                    super.getClientExtensions());
+
+            // An empty ticket asks the server to issue one
+            byte[] ext = (offered == null || offered.ticket == null) ?
+                TlsUtils.EMPTY_BYTES : offered.ticket;
+            clientExtensions.put(
+                Integers.valueOf(ExtensionType.session_ticket), ext);
+            return clientExtensions;
+        }
+
+        public void processServerExtensions(Hashtable serverExtensions)
+                throws IOException {
+            super.processServerExtensions(serverExtensions);
+            this.serverExtensions = serverExtensions;
+        }
+
+        public void notifyNewSessionTicket(NewSessionTicket newSessionTicket)
+                throws IOException {
+            newTicket = newSessionTicket.getTicket();
+        }
+
+        public TlsAuthentication getAuthentication() throws IOException {
+            return new TlsAuthentication() {
+                public void notifyServerCertificate(
+                        org.bouncycastle.crypto.tls.Certificate serverCertificate)
+                        throws IOException {
+                    // Capture the server certificate information!
+                    certificate = serverCertificate;
+                }
+
+                public TlsCredentials getClientCredentials(
+                        CertificateRequest certificateRequest) throws IOException {
+                    return null;
+                }
+            };
+        }
+
+        public void notifyHandshakeComplete() throws IOException {
+            super.notifyHandshakeComplete();
+
+            session = context.getResumableSession();
+            ticket = newTicket;
+
+            if (offered != null && session == offered.session) {
+                resumed = offered;
+                if (ticket == null) {
+                    ticket = offered.ticket;
+                }
+            } else if (session == null && ticket != null) {
+                /*
+                 * RFC 5077 3.4. A ticket replaces the session ID, so the
+                 * session is rebuilt from the handshake under an ID of
+                 * our own that the server echoes when it accepts the
+                 * ticket.
+                 */
+                SecurityParameters sp = context.getSecurityParameters();
+                SessionParameters params = new SessionParameters.Builder()
+                    .setCipherSuite(sp.getCipherSuite())
+                    .setCompressionAlgorithm(sp.getCompressionAlgorithm())
+                    .setMasterSecret(sp.getMasterSecret())
+                    .setPeerCertificate(certificate)
+                    .setServerExtensions(serverExtensions)
+                    .build();
+
+                byte[] sessionID = new byte[32];
+                context.getNonceRandomGenerator().nextBytes(sessionID);
+                session = TlsUtils.importSession(sessionID, params);
+            }
+        }
+    }
+
     /**
      * Returns the InputStream associated with this SSLStreamConnection.
      *
@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) Max Mu
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * Please visit www.joshvm.org if you need additional information or
+ * have any questions.
+ */
+
+package com.sun.midp.ssl;
+
+import java.io.IOException;
+import java.util.Vector;
+
+import com.sun.midp.pki.X509Certificate;
+
+import org.bouncycastle.crypto.tls.TlsSession;
+import org.bouncycastle.util.Arrays;
+
+/**
+ * Client side cache of resumable TLS sessions and of server certificate
+ * chains that already passed verification. Both caches are small, bounded
+ * and evict the least recently used entry.
+ */
+final class SSLSessionCache {
+    /** Maximum number of host:port entries kept for resumption. */
+    private static final int MAX_SESSIONS = 8;
+    /** Maximum number of verified certificate chains kept. */
+    private static final int MAX_CHAINS = 8;
+
+    /** Resumable sessions, most recently used last. */
+    private static final Vector sessions = new Vector(MAX_SESSIONS);
+    /** Verified certificate chains, most recently used last. */
+    private static final Vector chains = new Vector(MAX_CHAINS);
+
+    /** Prevents instantiation. */
+    private SSLSessionCache() {
+    }
+
+    /**
+     * Looks up a resumable session for the given server.
+     *
+     * @param host host name of the server
+     * @param port port number of the server
+     *
+     * @return the cached entry or null if there is none
+     */
+    static Entry getSession(String host, int port) {
+        String key = host + ":" + port;
+
+        synchronized (sessions) {
+            for (int i = sessions.size() - 1; i >= 0; i--) {
+                Entry e = (Entry)sessions.elementAt(i);
+                if (!e.key.equals(key)) {
+                    continue;
+                }
+
+                sessions.removeElementAt(i);
+                if (!e.session.isResumable()) {
+                    return null;
+                }
+
+                sessions.addElement(e);
+                return e;
+            }
+        }
+
+        return null;
+    }
+
+    /**
+     * Remembers a session after its handshake and certificate
+     * verification succeeded, replacing any older session for the
+     * same server.
+     *
+     * @param host host name of the server
+     * @param port port number of the server
+     * @param session session to offer on the next connection
+     * @param ticket session ticket to present with the session or null
+     *        for session ID resumption
+     * @param serverCert verified server certificate of the session
+     */
+    static void putSession(String host, int port, TlsSession session,
+                           byte[] ticket, X509Certificate serverCert) {
+        Entry e = new Entry(host + ":" + port, session, ticket, serverCert);
+
+        synchronized (sessions) {
+            for (int i = sessions.size() - 1; i >= 0; i--) {
+                if (((Entry)sessions.elementAt(i)).key.equals(e.key)) {
+                    sessions.removeElementAt(i);
+                }
+            }
+
+            if (sessions.size() >= MAX_SESSIONS) {
+                sessions.removeElementAt(0);
+            }
+
+            sessions.addElement(e);
+        }
+    }
+
+    /**
+     * Drops the session cached for the given server, if any.
+     *
+     * @param host host name of the server
+     * @param port port number of the server
+     */
+    static void removeSession(String host, int port) {
+        String key = host + ":" + port;
+
+        synchronized (sessions) {
+            for (int i = sessions.size() - 1; i >= 0; i--) {
+                if (((Entry)sessions.elementAt(i)).key.equals(key)) {
+                    sessions.removeElementAt(i);
+                }
+            }
+        }
+    }
+
+    /**
+     * Looks up a certificate chain that was verified before. The
+     * validity period of every certificate is checked again, the
+     * signatures are not.
+     *
+     * @param encoded DER encoding of each certificate, server first
+     *
+     * @return the verified server certificate or null if the chain
+     *         has not been verified yet or is no longer valid
+     */
+    static X509Certificate getVerifiedChain(byte[][] encoded) {
+        synchronized (chains) {
+            for (int i = chains.size() - 1; i >= 0; i--) {
+                Chain c = (Chain)chains.elementAt(i);
+                if (!c.matches(encoded)) {
+                    continue;
+                }
+
+                chains.removeElementAt(i);
+                try {
+                    for (int j = 0; j < c.certs.size(); j++) {
+                        ((X509Certificate)c.certs.elementAt(j)).checkValidity();
+                    }
+                } catch (IOException ioe) {
+                    return null;
+                }
+
+                chains.addElement(c);
+                return (X509Certificate)c.certs.elementAt(0);
+            }
+        }
+
+        return null;
+    }
+
+    /**
+     * Remembers a certificate chain that passed verification.
+     *
+     * @param encoded DER encoding of each certificate, server first
+     * @param certs the parsed certificates in the same order
+     */
+    static void putVerifiedChain(byte[][] encoded, Vector certs) {
+        synchronized (chains) {
+            if (chains.size() >= MAX_CHAINS) {
+                chains.removeElementAt(0);
+            }
+
+            chains.addElement(new Chain(encoded, certs));
+        }
+    }
+
+    /** A resumable session of one server. */
+    static final class Entry {
+        /** host:port of the server. */
+        final String key;
+        /** Session to offer in the ClientHello. */
+        final TlsSession session;
+        /** Session ticket to present or null. */
+        final byte[] ticket;
+        /** Server certificate verified when the session was created. */
+        final X509Certificate serverCert;
+
+        Entry(String key, TlsSession session, byte[] ticket,
+              X509Certificate serverCert) {
+            this.key = key;
+            this.session = session;
+            this.ticket = ticket;
+            this.serverCert = serverCert;
+        }
+    }
+
+    /** A certificate chain that passed verification. */
+    private static final class Chain {
+        /** DER encoding of each certificate, server first. */
+        private final byte[][] encoded;
+        /** Parsed certificates, server first. */
+        private final Vector certs;
+
+        Chain(byte[][] encoded, Vector certs) {
+            this.encoded = encoded;
+            this.certs = certs;
+        }
+
+        boolean matches(byte[][] other) {
+            if (other.length != encoded.length) {
+                return false;
+            }
+
+            for (int i = 0; i < encoded.length; i++) {
+                if (!Arrays.areEqual(encoded[i], other[i])) {
+                    return false;
+                }
+            }
+
+            return true;
+        }
+    }
+}
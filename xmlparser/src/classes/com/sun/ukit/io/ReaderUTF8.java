@@ -49,11 +49,15 @@ public class ReaderUTF8 extends Reader
 {
 	private static final int maxBytesInUTF8Character = 3;
 
+	/** Returned by decode at a UCS-4 character. */
+	private static final int UCS4_CHARACTER = -1;
+
 	private InputStream is;
 
-	final private byte[]	buff = new byte[128];
+	final private byte[]	buff = new byte[512];
 	private int     		bidx = 0;
 	private int     		bcnt = 0;
+	final private int[]		bpos = new int[1];
 
 	/**
 	 * Constructor.
@@ -95,53 +99,40 @@ public class ReaderUTF8 extends Reader
 	 * @exception IOException If any IO errors occur.
 	 * @exception UnsupportedEncodingException If UCS-4 character occur in the 
 	 *  stream.
+	 * @exception IndexOutOfBoundsException If off or len do not describe a
+	 *  range within cbuf.
 	 */
 	public int read(char[] cbuf, int off, int len) throws IOException
 	{
+		if (off < 0 || len < 0 || len > cbuf.length - off)
+			throw new IndexOutOfBoundsException();
 		int num = 0;
 		while (num < len) {
-			if (bcnt - bidx < maxBytesInUTF8Character){
-//System.out.println( "bcnt = " + bcnt + ", bidx = " + bidx + ", num = " + num );				
-				if( bidx > bcnt )
-					break;
-				fillBuffer();
-				if( bcnt - bidx == 0 ){
-					if( num == 0 )
-						return -1;
-					break;
+			if (bidx < bcnt) {
+				int count = decode(buff, bidx, bcnt, cbuf, off + num, len - num, bpos);
+				bidx = bpos[0];
+				if (count < 0) {
+					if (count == UCS4_CHARACTER)
+						throw new UnsupportedEncodingException();
+					throw new UTFDataFormatException();
 				}
-			}
-			char val = (char)buff[bidx++];
-			if (val <= 0x7f) {
-				cbuf[off++] = val;
-			} else {
-				switch (val & 0xf0) {
-				case 0xc0:
-				case 0xd0:
-					cbuf[off++] = (char)(((val & 0x1f) << 6) | (buff[bidx++] & 0x3f));
+				num += count;
+				if (num == len)
 					break;
-	
-				case 0xe0:
-					cbuf[off++] = (char)(((val & 0x0f) << 12) | 
-						((buff[bidx++] & 0x3f) << 6) | (buff[bidx++] & 0x3f));
-					break;
-	
-				case 0xf0:	// UCS-4 character
-					throw new UnsupportedEncodingException();
-	
-				default:
-					throw new UTFDataFormatException();
+			}
+			//		Only a part of a character or nothing is left
+			int left = bcnt - bidx;
+			fillBuffer();
+			if (bcnt - bidx == left) {
+				if (left > 0) { // last input UTF-8 character is wrong 
+					bidx = bcnt = 0;
+					throw new EOFException();
 				}
+				if (num == 0)
+					return -1;
+				break;
 			}
-			num++;
-		}
-		if( bidx > bcnt ){ // last input UTF-8 character is wrong 
-			bidx = bcnt = 0;
-			throw new EOFException();
 		}
-//System.out.print( "ReaderUTF8.read[" + num + "]:" );
-//for( int o = off - num; o < off; o++) System.out.print( cbuf[o] );
-//System.out.println();
 		return num;
 	}
 
@@ -190,6 +181,24 @@ public class ReaderUTF8 extends Reader
 		return val;
 	}
 
+	/**
+	 * Decodes the complete UTF-8 characters of a byte buffer. Decoding
+	 * stops in front of a character which is not complete in the buffer.
+	 *
+	 * @param in UTF-8 bytes.
+	 * @param off Offset of the first byte to decode.
+	 * @param end Offset after the last byte to decode.
+	 * @param out Destination buffer.
+	 * @param outOff Offset at which to start storing characters.
+	 * @param outLen Maximum number of characters to store.
+	 * @param pos The offset of the first byte not decoded is stored in
+	 *  pos[0].
+	 * @return The number of characters decoded, -1 at a UCS-4 character 
+	 *  or -2 at a byte which cannot start a character.
+	 */
+	private static native int decode(byte[] in, int off, int end, 
+		char[] out, int outOff, int outLen, int[] pos);
+
 	/**
 	 * Closes the stream.
 	 *
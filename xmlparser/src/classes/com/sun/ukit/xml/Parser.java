@@ -54,6 +54,8 @@ public abstract class Parser
 
 	protected final static int BUFFSIZE_READER = 512;
 	protected final static int BUFFSIZE_PARSER = 128;
+	private final static int   NAMES_SIZE      = 64;   // must be a power of 2
+	private final static int   NAMES_MAX       = 256;
 
 	/** The end of stream character. */
 	public final static char EOS = 0xffff;
@@ -190,6 +192,14 @@ public abstract class Parser
 
 	private Pair    mDltd;   // deleted objects for reuse
 
+	// Names read so far, looked up by qname characters. Repeated 
+	// element and attribute names share the characters and the strings.
+	// mNames[i].chars - qName characters (see: bname)
+	// mNames[i].name  - qName string
+	// mNames[i].value - local name string
+	private Pair[]  mNames = new Pair[NAMES_SIZE];
+	private int     mNamesNum;  // number of names in the table
+
 	/**
 	 * Default prefixes and special attributes
 	 */
@@ -382,6 +392,10 @@ public abstract class Parser
 		if ((mDoc != null) && (mDoc.src != null)) {
 			try { mDoc.src.close(); } catch (IOException ioe) {}
 		}
+		//		Names
+		for (int i = 0; i < NAMES_SIZE; i++)
+			mNames[i] = null;
+		mNamesNum = 0;
 		mPEnt = null;
 		mEnt  = null;
 		mDoc  = null;
@@ -473,8 +487,11 @@ public abstract class Parser
 					}
 					//		Read an element name and put it on top of the 
 					//		element stack
-					mElm.chars = qname(mIsNSAware);
-					mElm.name  = (mIsNSAware)? mElm.local(): mElm.qname();
+					mBuffIdx = -1;  // clean parser buffer
+					bname(mIsNSAware);
+					Pair qn = bqname();
+					mElm.chars = qn.chars;
+					mElm.name  = (mIsNSAware)? qn.value: qn.name;
 					mElm.num   = 0;     // attribute counter
 					//		Find the list of defined attributes of the current 
 					//		element 
@@ -586,17 +603,8 @@ public abstract class Parser
 				case EOS:
 					panic(FAULT_UNEXPECTED_EOF);
 
-				case ' ':  // characters not supported by bappend()
-				case '\"':
-				case '\'':
-				case '\n':
-				case '\t':
-				case '%':
-					bappend(ch);
-					break;
-
 				default:
-					bappend();
+					btext();
 					break;
 				}
 				break;
@@ -2232,9 +2240,46 @@ public abstract class Parser
 	{
 		mBuffIdx = -1;
 		bname(ns);
-		char chars[] = new char[mBuffIdx + 1];
-		System.arraycopy(mBuff, 0, chars, 0, mBuffIdx + 1);
-		return chars;
+		return bqname().chars;
+	}
+
+	/**
+	 * Looks up the qualified name in the buffer in the table of names 
+	 * read so far and adds it if it is new.
+	 *
+	 * @return The table entry of the qualified name.
+	 */
+	private Pair bqname()
+	{
+		int hash = 0;
+		for (int i = 0; i <= mBuffIdx; i++)
+			hash = 31 * hash + mBuff[i];
+		int idx = hash & (NAMES_SIZE - 1);
+		names: for (Pair qn = mNames[idx]; qn != null; qn = qn.next) {
+			char[] chars = qn.chars;
+			if (chars.length != (mBuffIdx + 1))
+				continue names;
+			for (int i = 0; i <= mBuffIdx; i++) {
+				if (chars[i] != mBuff[i])
+					continue names;
+			}
+			return qn;
+		}
+		//		A new name. Start over when there are too many names.
+		if (mNamesNum >= NAMES_MAX) {
+			for (int i = 0; i < NAMES_SIZE; i++)
+				mNames[i] = null;
+			mNamesNum = 0;
+		}
+		Pair qn  = new Pair();
+		qn.chars = new char[mBuffIdx + 1];
+		System.arraycopy(mBuff, 0, qn.chars, 0, mBuffIdx + 1);
+		qn.name  = qn.qname();
+		qn.value = (qn.chars[0] != 0)? qn.local(): qn.name;
+		qn.next  = mNames[idx];
+		mNames[idx] = qn;
+		mNamesNum++;
+		return qn;
 	}
 
 	/**
@@ -3133,6 +3178,31 @@ public abstract class Parser
 		}
 	}
 
+	/**
+	 * Appends character data to parser's buffer starting with the last 
+	 * read character and until one of the characters which ends the text 
+	 * content of an element: '<', '&', '\r' or EOS. Only the characters 
+	 * of the current reading buffer are appended.
+	 */
+	protected void btext()
+		throws Exception
+	{
+		int cstart = mChIdx - 1;
+		mChIdx = scanText(mChars, mChIdx, mChLen);
+		bcopy(cstart, mBuffIdx + 1);
+	}
+
+	/**
+	 * Finds the end of a run of character data.
+	 *
+	 * @param chars The characters to search.
+	 * @param from The index to start the search at.
+	 * @param to The index after the last character to search.
+	 * @return The index of the first '<', '&', '\r' or EOS character or 
+	 *  <code>to</code> if there is none.
+	 */
+	private static native int scanText(char[] chars, int from, int to);
+
 	/**
 	 * Appends a character to parser's buffer with normalization.
 	 *
@@ -0,0 +1,206 @@
+/*
+ * Copyright (C) Max Mu
+ * DO NOT ALTER OR REMOVE COPYRIGHT NOTICES OR THIS FILE HEADER
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * version 2, as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License version 2 for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.
+ *
+ * Please visit www.joshvm.org if you need additional information or
+ * have any questions.
+ */
+
+/**
+ * @file
+ *
+ * Buffer scanning helpers for the com.sun.ukit XML parser: UTF-8
+ * decoding for com.sun.ukit.io.ReaderUTF8 and the character data scan
+ * for com.sun.ukit.xml.Parser. Both work on whole buffers in place, the
+ * Java side only sees the resulting positions.
+ */
+
+#include <kni.h>
+#include <sni.h>
+
+/* Returned by decode for a 4 byte (UCS-4) sequence */
+#define UTF8_UCS4 -1
+/* Returned by decode for a byte that cannot start a sequence */
+#define UTF8_BAD_LEAD -2
+
+/* End of stream character of the parser */
+#define XML_EOS 0xffff
+
+/*
+ * Characters below 0x40 that end a run of character data: '<' starts
+ * markup, '&' a reference and '\r' needs end of line handling.
+ */
+static const unsigned char text_stop[0x40] = {
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 0, 0, 0
+};
+
+/*
+ * Decodes complete UTF-8 sequences from in[*pos..end) into out. Decoding
+ * stops in front of a sequence that is not complete in the input, so
+ * the caller can refill and continue. Like the Java decoder, continuation
+ * bytes are not validated.
+ *
+ * @return number of characters decoded or one of the UTF8_ error codes,
+ *         *pos is left at the first byte not decoded
+ */
+static int utf8_decode(const unsigned char* in, int* pos, int end,
+                       jchar* out, int outLen) {
+    int i = *pos;
+    int n = 0;
+
+    while (n < outLen && i < end) {
+        unsigned int c = in[i];
+
+        if (c < 0x80) {
+            /* ASCII runs are widened a word at a time */
+            while (n + 4 <= outLen && i + 4 <= end &&
+                   ((in[i] | in[i + 1] | in[i + 2] | in[i + 3]) & 0x80) == 0) {
+                out[n] = in[i];
+                out[n + 1] = in[i + 1];
+                out[n + 2] = in[i + 2];
+                out[n + 3] = in[i + 3];
+                n += 4;
+                i += 4;
+            }
+            if (n < outLen && i < end && in[i] < 0x80) {
+                out[n++] = in[i++];
+            }
+            continue;
+        }
+
+        switch (c & 0xf0) {
+        case 0xc0:
+        case 0xd0:
+            if (i + 2 > end) {
+                goto done;
+            }
+            out[n++] = (jchar)(((c & 0x1f) << 6) | (in[i + 1] & 0x3f));
+            i += 2;
+            break;
+
+        case 0xe0:
+            if (i + 3 > end) {
+                goto done;
+            }
+            out[n++] = (jchar)(((c & 0x0f) << 12) |
+                ((in[i + 1] & 0x3f) << 6) | (in[i + 2] & 0x3f));
+            i += 3;
+            break;
+
+        case 0xf0:
+            *pos = i;
+            return UTF8_UCS4;
+
+        default:
+            *pos = i;
+            return UTF8_BAD_LEAD;
+        }
+    }
+
+done:
+    *pos = i;
+    return n;
+}
+
+/*=========================================================================
+ * FUNCTION:      decode([BII[CII[I)I (STATIC)
+ * CLASS:         com/sun/ukit/io/ReaderUTF8
+ * TYPE:          static native function
+ * OVERVIEW:      Decode the complete UTF-8 sequences of a byte buffer.
+ * INTERFACE (operand stack manipulation):
+ *   parameters:  in         UTF-8 bytes
+ *                off        offset of the first byte to decode
+ *                end        offset after the last byte to decode
+ *                out        character buffer
+ *                outOff     offset in the character buffer
+ *                outLen     space in the character buffer
+ *                pos        pos[0] receives the offset of the first byte
+ *                           not decoded
+ *   returns: number of characters decoded, -1 at a UCS-4 character or
+ *            -2 at a byte that cannot start a character
+ *=======================================================================*/
+KNIEXPORT KNI_RETURNTYPE_INT
+Java_com_sun_ukit_io_ReaderUTF8_decode() {
+    jint off = KNI_GetParameterAsInt(2);
+    jint end = KNI_GetParameterAsInt(3);
+    jint outOff = KNI_GetParameterAsInt(5);
+    jint outLen = KNI_GetParameterAsInt(6);
+    int pos = off;
+    int n;
+
+    KNI_StartHandles(3);
+    KNI_DeclareHandle(iin);
+    KNI_DeclareHandle(iout);
+    KNI_DeclareHandle(ipos);
+
+    KNI_GetParameterAsObject(1, iin);
+    KNI_GetParameterAsObject(4, iout);
+    KNI_GetParameterAsObject(7, ipos);
+
+    /*
+     * ReaderUTF8.read() checked the bounds of out, in is its own buffer.
+     * Nothing below can trigger a GC, so the data is decoded in place.
+     */
+    n = utf8_decode((unsigned char*)SNI_GetRawArrayPointer(iin), &pos, end,
+                    (jchar*)SNI_GetRawArrayPointer(iout) + outOff, outLen);
+    KNI_SetIntArrayElement(ipos, 0, (jint)pos);
+
+    KNI_EndHandles();
+    KNI_ReturnInt(n);
+}
+
+/*=========================================================================
+ * FUNCTION:      scanText([CII)I (STATIC)
+ * CLASS:         com/sun/ukit/xml/Parser
+ * TYPE:          static native function
+ * OVERVIEW:      Find the end of a run of plain character data.
+ * INTERFACE (operand stack manipulation):
+ *   parameters:  chars      character buffer
+ *                from       offset to start the search at
+ *                to         offset after the last character to search
+ *   returns: offset of the first '<', '&', '\r' or end of stream
+ *            character, or to if there is none
+ *=======================================================================*/
+KNIEXPORT KNI_RETURNTYPE_INT
+Java_com_sun_ukit_xml_Parser_scanText() {
+    jint from = KNI_GetParameterAsInt(2);
+    jint to = KNI_GetParameterAsInt(3);
+    const jchar* chars;
+    jint i;
+
+    KNI_StartHandles(1);
+    KNI_DeclareHandle(ichars);
+
+    KNI_GetParameterAsObject(1, ichars);
+
+    chars = (const jchar*)SNI_GetRawArrayPointer(ichars);
+    for (i = from; i < to; i++) {
+        jchar c = chars[i];
+        if (c < 0x40) {
+            if (text_stop[c]) {
+                break;
+            }
+        } else if (c == XML_EOS) {
+            break;
+        }
+    }
+
+    KNI_EndHandles();
+    KNI_ReturnInt(i);
+}